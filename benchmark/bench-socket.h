@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (c) 2026 MariaDB Corporation plc
+
+/* Sockets portability bits shared by the benchmark utilities */
+#ifndef _BENCH_SOCKET_H_
+#define _BENCH_SOCKET_H_
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+# include <winsock2.h>
+# include <ws2tcpip.h>
+typedef SOCKET socket_t;
+# define CLOSE_SOCKET closesocket
+# define SHUT_RD SD_RECEIVE
+# define SHUT_WR SD_SEND
+# define SHUT_RDWR SD_BOTH
+# define SEND_FLAGS 0
+#else
+# include <arpa/inet.h>
+# include <netdb.h>
+# include <netinet/in.h>
+# include <netinet/tcp.h>
+# include <sys/socket.h>
+# include <unistd.h>
+typedef int socket_t;
+# define CLOSE_SOCKET close
+# define INVALID_SOCKET (-1)
+/* Peer closing the connection must not kill the process with SIGPIPE */
+# define SEND_FLAGS MSG_NOSIGNAL
+#endif
+
+namespace bench
+{
+/* Has to exist while sockets are used. No-op everywhere but on Windows */
+struct SocketsInit
+{
+#ifdef _WIN32
+  SocketsInit() { WSADATA data; WSAStartup(MAKEWORD(2, 2), &data); }
+  ~SocketsInit() { WSACleanup(); }
+#else
+  SocketsInit() {}
+#endif
+};
+
+/* Opens socket listening on 127.0.0.1. Port 0 picks a free one, and port is set to it. Returns INVALID_SOCKET on error */
+inline socket_t listenLocal(uint16_t& port)
+{
+  socket_t listener= ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (listener == INVALID_SOCKET) {
+    return INVALID_SOCKET;
+  }
+  int reuse= 1;
+  ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+  sockaddr_in address;
+  std::memset(&address, 0, sizeof(address));
+  address.sin_family= AF_INET;
+  address.sin_addr.s_addr= htonl(INADDR_LOOPBACK);
+  address.sin_port= htons(port);
+  socklen_t addressLength= sizeof(address);
+
+  if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+      ::listen(listener, SOMAXCONN) != 0 ||
+      ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &addressLength) != 0) {
+    CLOSE_SOCKET(listener);
+    return INVALID_SOCKET;
+  }
+  port= ntohs(address.sin_port);
+  return listener;
+}
+
+inline void setNoDelay(socket_t socket)
+{
+  int noDelay= 1;
+  ::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+}
+
+/* Sends whole buffer. Returns false if connection has been closed or failed */
+inline bool sendAll(socket_t socket, const char* data, std::size_t length)
+{
+  while (length > 0) {
+    int sent= ::send(socket, data, static_cast<int>(length), SEND_FLAGS);
+    if (sent <= 0) {
+      return false;
+    }
+    data+= sent;
+    length-= static_cast<std::size_t>(sent);
+  }
+  return true;
+}
+}
+#endif
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (c) 2026 MariaDB Corporation plc
+
+/* Task throughput of the driver's background executors. Does not need a server - builds with the executors' sources,
+ * see README.md
+ */
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "pool/ThreadPoolExecutor.h"
+#include "pool/MariaDbThreadFactory.h"
+
+const int MAX_THREAD = 64;
+/* ThreadPoolExecutor worker pauses 10ms after each task, thus the number of tasks is kept low */
+const int TASKS = 1024;
+#define OPERATION_PER_SECOND_LABEL "nb operations per second"
+
+sql::ThreadPoolExecutor* newExecutor(sql::ThreadPoolExecutor*, int threads) {
+  sql::ThreadPoolExecutor* executor = new sql::ThreadPoolExecutor(threads, threads,
+    new sql::mariadb::MariaDbThreadFactory("bench"));
+  executor->prestartCoreThread();
+  return executor;
+}
+
+sql::WorkStealingExecutor* newExecutor(sql::WorkStealingExecutor*, int threads) {
+  sql::WorkStealingExecutor* executor = new sql::WorkStealingExecutor(threads, threads,
+    new sql::mariadb::MariaDbThreadFactory("bench"));
+  executor->prestartCoreThread();
+  return executor;
+}
+
+void waitFor(std::atomic<int>& done, int expected) {
+  while (done.load() < expected) {
+    std::this_thread::yield();
+  }
+}
+
+/* All tasks are submitted by one external thread */
+template <class ExecutorT>
+static void BM_EXECUTE(benchmark::State& state) {
+  std::unique_ptr<ExecutorT> executor(newExecutor(static_cast<ExecutorT*>(nullptr), static_cast<int>(state.range(0))));
+  int numOperation = 0;
+  for (auto _ : state) {
+    std::atomic<int> done(0);
+    for (int i = 0; i < TASKS; ++i) {
+      executor->execute([&done]() { ++done; });
+    }
+    waitFor(done, TASKS);
+    numOperation += TASKS;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+}
+
+/* Each of the few tasks submitted from outside submits further tasks from the worker */
+template <class ExecutorT>
+static void BM_EXECUTE_NESTED(benchmark::State& state) {
+  const int rootTasks = 16;
+  std::unique_ptr<ExecutorT> executor(newExecutor(static_cast<ExecutorT*>(nullptr), static_cast<int>(state.range(0))));
+  ExecutorT* exec = executor.get();
+  int numOperation = 0;
+  for (auto _ : state) {
+    std::atomic<int> done(0);
+    for (int i = 0; i < rootTasks; ++i) {
+      exec->execute([exec, &done]() {
+        for (int j = 0; j < TASKS / rootTasks - 1; ++j) {
+          exec->execute([&done]() { ++done; });
+        }
+        ++done;
+      });
+    }
+    waitFor(done, TASKS);
+    numOperation += TASKS;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_TEMPLATE(BM_EXECUTE, sql::ThreadPoolExecutor)->Name("ThreadPoolExecutor execute")->RangeMultiplier(2)->Range(1, MAX_THREAD)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_EXECUTE, sql::WorkStealingExecutor)->Name("WorkStealingExecutor execute")->RangeMultiplier(2)->Range(1, MAX_THREAD)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_EXECUTE_NESTED, sql::ThreadPoolExecutor)->Name("ThreadPoolExecutor nested execute")->RangeMultiplier(2)->Range(1, MAX_THREAD)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_EXECUTE_NESTED, sql::WorkStealingExecutor)->Name("WorkStealingExecutor nested execute")->RangeMultiplier(2)->Range(1, MAX_THREAD)->UseRealTime();
+
+BENCHMARK_MAIN();
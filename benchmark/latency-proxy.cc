@@ -0,0 +1,306 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (c) 2026 MariaDB Corporation plc
+
+#include "latency-proxy.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <random>
+#include <stdexcept>
+
+#include "bench-socket.h"
+
+namespace proxy
+{
+namespace
+{
+typedef std::chrono::steady_clock Clock;
+const std::size_t CHUNK_SIZE= 64*1024;
+
+/* Data read from one side, and the time it may be written to the other. Empty data means the end of stream */
+struct Chunk
+{
+  Clock::time_point release;
+  std::string data;
+};
+
+socket_t connectTo(const std::string& host, uint16_t port)
+{
+  addrinfo hints, *addresses= nullptr;
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_family= AF_UNSPEC;
+  hints.ai_socktype= SOCK_STREAM;
+
+  if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+    return INVALID_SOCKET;
+  }
+  socket_t result= INVALID_SOCKET;
+  for (addrinfo* address= addresses; address != nullptr && result == INVALID_SOCKET; address= address->ai_next) {
+    result= ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (result != INVALID_SOCKET && ::connect(result, address->ai_addr, static_cast<socklen_t>(address->ai_addrlen)) != 0) {
+      CLOSE_SOCKET(result);
+      result= INVALID_SOCKET;
+    }
+  }
+  ::freeaddrinfo(addresses);
+  return result;
+}
+}
+
+/* One direction of a proxied connection. Reader thread timestamps what it reads, and writer thread writes it out when
+ * its time comes */
+class Pipe
+{
+  socket_t from;
+  socket_t to;
+  const Direction direction;
+  std::mutex lock;
+  std::condition_variable ready;
+  std::deque<Chunk> chunks;
+  Clock::time_point lastRelease;
+  std::mt19937 random;
+  std::thread reader;
+  std::thread writer;
+  std::atomic<bool> done{false};
+
+  Clock::time_point releaseTime()
+  {
+    Clock::time_point release= Clock::now() + direction.delay;
+    if (direction.jitter.count() > 0) {
+      std::uniform_int_distribution<int64_t> jitter(-direction.jitter.count(), direction.jitter.count());
+      release+= std::chrono::microseconds(jitter(random));
+    }
+    /* TCP delivers in order - a chunk can't overtake the previous one */
+    lastRelease= std::max(release, lastRelease);
+    return lastRelease;
+  }
+
+  void push(Chunk&& chunk)
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    chunks.push_back(std::move(chunk));
+    ready.notify_one();
+  }
+
+  void read()
+  {
+    std::string buffer(CHUNK_SIZE, '\0');
+    while (true) {
+      int received= ::recv(from, &buffer[0], static_cast<int>(buffer.size()), 0);
+      if (received <= 0) {
+        push(Chunk{ Clock::now(), std::string() });
+        return;
+      }
+      push(Chunk{ releaseTime(), buffer.substr(0, static_cast<std::size_t>(received)) });
+    }
+  }
+
+  void write()
+  {
+    Clock::time_point nextFree= Clock::now();
+    while (true) {
+      Chunk chunk;
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        ready.wait(guard, [this]() { return !chunks.empty(); });
+        chunk= std::move(chunks.front());
+        chunks.pop_front();
+      }
+      if (chunk.data.empty()) {
+        ::shutdown(to, SHUT_WR);
+        break;
+      }
+      Clock::time_point sendAt= std::max(chunk.release, nextFree);
+      std::this_thread::sleep_until(sendAt);
+      if (direction.bytesPerSecond > 0) {
+        nextFree= sendAt + std::chrono::microseconds(chunk.data.length()*1000000 / direction.bytesPerSecond);
+      }
+      if (!bench::sendAll(to, chunk.data.data(), chunk.data.length())) {
+        /* Other side is gone, reader has to stop too */
+        ::shutdown(from, SHUT_RD);
+        ::shutdown(to, SHUT_RDWR);
+        break;
+      }
+    }
+    done.store(true);
+  }
+
+public:
+  Pipe(socket_t from, socket_t to, const Direction& direction)
+    : from(from)
+    , to(to)
+    , direction(direction)
+    , lastRelease(Clock::now())
+    , random(std::random_device()())
+  {
+  }
+
+  void start()
+  {
+    reader= std::thread(&Pipe::read, this);
+    writer= std::thread(&Pipe::write, this);
+  }
+
+  bool isDone() const { return done.load(); }
+
+  void join()
+  {
+    reader.join();
+    writer.join();
+  }
+};
+
+struct Session
+{
+  socket_t client;
+  socket_t server;
+  Pipe toServer;
+  Pipe toClient;
+
+  Session(socket_t client, socket_t server, const Config& config)
+    : client(client)
+    , server(server)
+    , toServer(client, server, config.toServer)
+    , toClient(server, client, config.toClient)
+  {
+    toServer.start();
+    toClient.start();
+  }
+
+  bool isDone() const { return toServer.isDone() && toClient.isDone(); }
+
+  void shutdown()
+  {
+    ::shutdown(client, SHUT_RDWR);
+    ::shutdown(server, SHUT_RDWR);
+  }
+
+  ~Session()
+  {
+    toServer.join();
+    toClient.join();
+    CLOSE_SOCKET(client);
+    CLOSE_SOCKET(server);
+  }
+};
+
+
+Config Config::withRtt(uint16_t targetPort, std::chrono::microseconds rtt, std::chrono::microseconds jitter,
+  const std::string& targetHost)
+{
+  Config config;
+  config.targetHost= targetHost;
+  config.targetPort= targetPort;
+  config.toServer.delay= rtt / 2;
+  config.toServer.jitter= jitter;
+  config.toClient.delay= rtt - config.toServer.delay;
+  config.toClient.jitter= jitter;
+  return config;
+}
+
+
+LatencyProxy::LatencyProxy(const Config& _config, uint16_t _port)
+  : config(_config)
+  , listenSocket(static_cast<int64_t>(INVALID_SOCKET))
+  , port(_port)
+{
+  static bench::SocketsInit socketsInit;
+  socket_t listener= bench::listenLocal(port);
+  if (listener == INVALID_SOCKET) {
+    throw std::runtime_error("Latency proxy could not listen on port " + std::to_string(_port));
+  }
+  listenSocket= static_cast<int64_t>(listener);
+  acceptor= std::thread(&LatencyProxy::acceptLoop, this);
+}
+
+
+LatencyProxy::~LatencyProxy()
+{
+  stop();
+}
+
+
+void LatencyProxy::acceptLoop()
+{
+  while (!stopped.load()) {
+    socket_t client= ::accept(static_cast<socket_t>(listenSocket), nullptr, nullptr);
+    if (client == INVALID_SOCKET) {
+      if (stopped.load()) {
+        break;
+      }
+      continue;
+    }
+    socket_t server= connectTo(config.targetHost, config.targetPort);
+    if (server == INVALID_SOCKET) {
+      CLOSE_SOCKET(client);
+      continue;
+    }
+    bench::setNoDelay(client);
+    bench::setNoDelay(server);
+
+    std::lock_guard<std::mutex> guard(sessionsLock);
+    /* Reaping finished sessions, benchmarks of connect would pile them up otherwise */
+    sessions.erase(std::remove_if(sessions.begin(), sessions.end(),
+      [](const std::unique_ptr<Session>& session) { return session->isDone(); }), sessions.end());
+    if (stopped.load()) {
+      CLOSE_SOCKET(client);
+      CLOSE_SOCKET(server);
+      break;
+    }
+    sessions.emplace_back(new Session(client, server, config));
+  }
+}
+
+
+void LatencyProxy::stop()
+{
+  if (stopped.exchange(true)) {
+    return;
+  }
+  ::shutdown(static_cast<socket_t>(listenSocket), SHUT_RDWR);
+  CLOSE_SOCKET(static_cast<socket_t>(listenSocket));
+  if (acceptor.joinable()) {
+    acceptor.join();
+  }
+
+  std::vector<std::unique_ptr<Session>> closing;
+  {
+    std::lock_guard<std::mutex> guard(sessionsLock);
+    closing.swap(sessions);
+  }
+  for (auto& session : closing) {
+    session->shutdown();
+  }
+  /* Sessions' destructors join their threads */
+  closing.clear();
+}
+
+}
+
+
+#ifdef LATENCY_PROXY_MAIN
+#include <iostream>
+
+/* Standalone proxy, e.g. in front of a real server for main-benchmark, see README.md */
+int main(int argc, char** argv)
+{
+  if (argc < 5) {
+    std::cerr << "Usage: " << argv[0]
+      << " <listen port> <server host> <server port> <rtt us> [<jitter us> [<bytes per second each way>]]" << std::endl;
+    return 1;
+  }
+  proxy::Config config= proxy::Config::withRtt(static_cast<uint16_t>(std::stoi(argv[3])),
+    std::chrono::microseconds(std::stoll(argv[4])),
+    std::chrono::microseconds(argc > 5 ? std::stoll(argv[5]) : 0), argv[2]);
+  if (argc > 6) {
+    config.toServer.bytesPerSecond= config.toClient.bytesPerSecond= std::stoull(argv[6]);
+  }
+  proxy::LatencyProxy latencyProxy(config, static_cast<uint16_t>(std::stoi(argv[1])));
+  std::cout << "Forwarding 127.0.0.1:" << latencyProxy.getPort() << " to " << config.targetHost << ":"
+    << config.targetPort << std::endl;
+  while (true) {
+    std::this_thread::sleep_for(std::chrono::hours(1));
+  }
+}
+#endif
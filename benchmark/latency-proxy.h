@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (c) 2026 MariaDB Corporation plc
+
+/* Local TCP proxy, that forwards connections to a server adding delay, jitter and bandwidth cap in each direction.
+ * Emulates network round trip time on localhost, where round trips are almost free, and thus makes visible what
+ * pipelining, batching and bulk save when server is across the network.
+ *
+ * Data keeps its order - jitter only varies the delay of data chunks, as much as their order permits.
+ */
+#ifndef _LATENCY_PROXY_H_
+#define _LATENCY_PROXY_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace proxy
+{
+
+struct Direction
+{
+  std::chrono::microseconds delay{0};
+  /* Delay of every chunk of data varies randomly by up to +/- jitter */
+  std::chrono::microseconds jitter{0};
+  /* 0 - unlimited */
+  uint64_t bytesPerSecond= 0;
+};
+
+struct Config
+{
+  std::string targetHost= "127.0.0.1";
+  uint16_t targetPort= 3306;
+  Direction toServer;
+  Direction toClient;
+
+  /* Half of the round trip time in each direction */
+  static Config withRtt(uint16_t targetPort, std::chrono::microseconds rtt,
+    std::chrono::microseconds jitter= std::chrono::microseconds(0), const std::string& targetHost= "127.0.0.1");
+};
+
+struct Session;
+
+class LatencyProxy
+{
+  const Config config;
+  int64_t listenSocket;
+  uint16_t port;
+  std::thread acceptor;
+  std::atomic<bool> stopped{false};
+
+  std::mutex sessionsLock;
+  std::vector<std::unique_ptr<Session>> sessions;
+
+  void acceptLoop();
+
+public:
+  /* Starts listening on 127.0.0.1. With port 0 a free port is picked, see getPort() */
+  explicit LatencyProxy(const Config& config, uint16_t port= 0);
+  ~LatencyProxy();
+
+  LatencyProxy(const LatencyProxy&)= delete;
+  LatencyProxy& operator=(const LatencyProxy&)= delete;
+
+  uint16_t getPort() const { return port; }
+  const Config& getConfig() const { return config; }
+  /* Closes listening socket and all connections, and joins their threads */
+  void stop();
+};
+
+}
+#endif
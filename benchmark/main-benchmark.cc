@@ -3,8 +3,8 @@
 #include <string>
 #include <cstring>
 #include <stdlib.h>
+#include <sstream>
 
-const int MAX_THREAD = 1;
 #define OPERATION_PER_SECOND_LABEL "nb operations per second"
 
 std::string GetEnvironmentVariableOrDefault(const std::string& variable_name,
@@ -14,6 +14,9 @@ std::string GetEnvironmentVariableOrDefault(const std::string& variable_name,
     return value ? value : default_value;
 }
 
+// Benchmarks run on 1, 2, 4 ... MAX_THREAD threads. Set TEST_MAX_THREAD=1 for single thread run
+const int MAX_THREAD = std::stoi(GetEnvironmentVariableOrDefault("TEST_MAX_THREAD", "64"));
+
 std::string DB_PORT = GetEnvironmentVariableOrDefault("TEST_DB_PORT", "3306");
 std::string DB_DATABASE = GetEnvironmentVariableOrDefault("TEST_DB_DATABASE", "bench");
 std::string DB_USER = GetEnvironmentVariableOrDefault("TEST_DB_USER", "root");
@@ -351,5 +354,292 @@ BENCHMARK(BM_DO_1000_PARAMS)->Name(TYPE + " DO 1000 params")->ThreadRange(1, MAX
     BENCHMARK(BM_INSERT_BATCH_CLIENT_REWRITE)->Name(TYPE + " insert batch client rewrite")->ThreadRange(1, MAX_THREAD)->UseRealTime()->Setup(setup_insert_batch);
 #endif
 
-BENCHMARK_MAIN();
+// ------------------------------ connection establishment and pool checkout ------------------------------
+
+static void BM_CONNECT(benchmark::State& state) {
+  int numOperation = 0;
+  for (auto _ : state) {
+    sql::Connection *conn = connect("");
+    delete conn;
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_CONNECT)->Name(TYPE + " connect")->ThreadRange(1, MAX_THREAD)->UseRealTime();
+
+#ifndef MYSQL
+// Checkout from the pool and giving connection back. Pool is created by the first connection, and has a connection
+// for each thread
+static void BM_POOL_CHECKOUT(benchmark::State& state) {
+  const std::string poolOptions = "?pool=true&minPoolSize=" + std::to_string(MAX_THREAD) + "&maxPoolSize=" + std::to_string(MAX_THREAD);
+  delete connect(poolOptions);
+  int numOperation = 0;
+  for (auto _ : state) {
+    sql::Connection *conn = connect(poolOptions);
+    delete conn;
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+}
+
+// Checkout and a query - to compare with connect + the same query
+static void BM_POOL_CHECKOUT_SELECT_1(benchmark::State& state) {
+  const std::string poolOptions = "?pool=true&minPoolSize=" + std::to_string(MAX_THREAD) + "&maxPoolSize=" + std::to_string(MAX_THREAD);
+  int numOperation = 0;
+  for (auto _ : state) {
+    sql::Connection *conn = connect(poolOptions);
+    benchmark::DoNotOptimize(select_1(state, conn));
+    delete conn;
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_POOL_CHECKOUT)->Name(TYPE + " pool checkout")->ThreadRange(1, MAX_THREAD)->UseRealTime();
+BENCHMARK(BM_POOL_CHECKOUT_SELECT_1)->Name(TYPE + " pool checkout + SELECT 1")->ThreadRange(1, MAX_THREAD)->UseRealTime();
+#endif
+
+static void BM_CONNECT_SELECT_1(benchmark::State& state) {
+  int numOperation = 0;
+  for (auto _ : state) {
+    sql::Connection *conn = connect("");
+    benchmark::DoNotOptimize(select_1(state, conn));
+    delete conn;
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_CONNECT_SELECT_1)->Name(TYPE + " connect + SELECT 1")->ThreadRange(1, MAX_THREAD)->UseRealTime();
+
+// ------------------------------ large result sets: cached vs streaming ------------------------------
+
+void select_large(benchmark::State& state, sql::Connection* conn, int fetchSize) {
+  try {
+    sql::Statement *stmt = conn->createStatement();
+    if (fetchSize > 0) {
+      stmt->setFetchSize(fetchSize);
+    }
+    sql::ResultSet *res = stmt->executeQuery("select seq, 'abcdefghijabcdefghijabcdefghijaa' from seq_1_to_100000");
+    int val1;
+    sql::SQLString val2;
+    while (res->next()) {
+      benchmark::DoNotOptimize(val1 = res->getInt(1));
+      benchmark::DoNotOptimize(val2 = res->getString(2));
+      benchmark::ClobberMemory();
+    }
+    delete res;
+    delete stmt;
+  } catch(sql::SQLException& e){
+    state.SkipWithError(e.what());
+  }
+}
+
+static void BM_SELECT_LARGE_CACHED(benchmark::State& state) {
+  sql::Connection *conn = connect("");
+  int numOperation = 0;
+  for (auto _ : state) {
+    select_large(state, conn, 0);
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+  delete conn;
+}
+
+BENCHMARK(BM_SELECT_LARGE_CACHED)->Name(TYPE + " SELECT 100000 rows - cached")->ThreadRange(1, MAX_THREAD)->UseRealTime();
+
+#ifndef MYSQL
+// state.range(0) is the fetch size
+static void BM_SELECT_LARGE_STREAMING(benchmark::State& state) {
+  sql::Connection *conn = connect("");
+  int numOperation = 0;
+  for (auto _ : state) {
+    select_large(state, conn, static_cast<int>(state.range(0)));
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+  delete conn;
+}
+
+BENCHMARK(BM_SELECT_LARGE_STREAMING)->Name(TYPE + " SELECT 100000 rows - streaming")->Arg(100)->Arg(10000)->ThreadRange(1, MAX_THREAD)->UseRealTime();
+#endif
+
+// ------------------------------ getters by label vs by index ------------------------------
+
+int select_1000_rows_getters(benchmark::State& state, sql::Connection* conn, bool byLabel) {
+  int sum = 0;
+  try {
+    sql::Statement *stmt = conn->createStatement();
+    sql::ResultSet *res = stmt->executeQuery("select seq as c1, seq+1 as c2, seq+2 as c3, seq+3 as c4, seq+4 as c5 from seq_1_to_1000");
+    while (res->next()) {
+      if (byLabel) {
+        sum += res->getInt("c1") + res->getInt("c2") + res->getInt("c3") + res->getInt("c4") + res->getInt("c5");
+      }
+      else {
+        sum += res->getInt(1) + res->getInt(2) + res->getInt(3) + res->getInt(4) + res->getInt(5);
+      }
+    }
+    delete res;
+    delete stmt;
+  } catch(sql::SQLException& e){
+    state.SkipWithError(e.what());
+  }
+  return sum;
+}
+
+static void BM_GETTERS_BY_INDEX(benchmark::State& state) {
+  sql::Connection *conn = connect("");
+  int numOperation = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(select_1000_rows_getters(state, conn, false));
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+  delete conn;
+}
+
+static void BM_GETTERS_BY_LABEL(benchmark::State& state) {
+  sql::Connection *conn = connect("");
+  int numOperation = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(select_1000_rows_getters(state, conn, true));
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+  delete conn;
+}
+
+BENCHMARK(BM_GETTERS_BY_INDEX)->Name(TYPE + " SELECT 1000 rows x 5 int - getInt(index)")->ThreadRange(1, MAX_THREAD)->UseRealTime();
+BENCHMARK(BM_GETTERS_BY_LABEL)->Name(TYPE + " SELECT 1000 rows x 5 int - getInt(label)")->ThreadRange(1, MAX_THREAD)->UseRealTime();
+
+// ------------------------------ BLOB round trip ------------------------------
+
+// Sends BLOB of state.range(0) bytes as a parameter, and reads it back
+void blob_round_trip(benchmark::State& state, sql::Connection* conn, const std::string& data) {
+  try {
+    sql::PreparedStatement *prep_stmt = conn->prepareStatement("SELECT ?");
+    std::istringstream blob(data);
+    prep_stmt->setBlob(1, &blob);
+    sql::ResultSet *res = prep_stmt->executeQuery();
+    if (res->next()) {
+      std::istream *received = res->getBlob(1);
+      char buffer[8192];
+      std::size_t total = 0;
+      while (received->read(buffer, sizeof(buffer)) || received->gcount() > 0) {
+        total += static_cast<std::size_t>(received->gcount());
+      }
+      if (total != data.length()) {
+        state.SkipWithError("BLOB length mismatch");
+      }
+      delete received;
+    }
+    delete res;
+    delete prep_stmt;
+  } catch(sql::SQLException& e){
+    state.SkipWithError(e.what());
+  }
+}
+
+static void BM_BLOB_ROUND_TRIP(benchmark::State& state) {
+  sql::Connection *conn = connect("");
+  const std::string data(static_cast<std::size_t>(state.range(0)), 'b');
+  int numOperation = 0;
+  for (auto _ : state) {
+    blob_round_trip(state, conn, data);
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+  state.SetBytesProcessed(static_cast<int64_t>(numOperation) * state.range(0) * 2);
+  delete conn;
+}
+
+#ifndef MYSQL
+static void BM_BLOB_ROUND_TRIP_SRV_PREPARED(benchmark::State& state) {
+  sql::Connection *conn = connect("?useServerPrepStmts=true");
+  const std::string data(static_cast<std::size_t>(state.range(0)), 'b');
+  int numOperation = 0;
+  for (auto _ : state) {
+    blob_round_trip(state, conn, data);
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+  state.SetBytesProcessed(static_cast<int64_t>(numOperation) * state.range(0) * 2);
+  delete conn;
+}
+#endif
+
+BENCHMARK(BM_BLOB_ROUND_TRIP)->Name(TYPE + " BLOB round trip")->Arg(1024)->Arg(64*1024)->Arg(1024*1024)->UseRealTime();
+#ifndef MYSQL
+BENCHMARK(BM_BLOB_ROUND_TRIP_SRV_PREPARED)->Name(TYPE + " BLOB round trip - srv prepared")->Arg(1024)->Arg(64*1024)->Arg(1024*1024)->UseRealTime();
+#endif
+
+#ifndef MYSQL
+// ------------------------------ batch: text vs binary vs bulk, by batch size ------------------------------
+
+    void insert_batch_sized(benchmark::State& state, sql::Connection* conn, const std::string& value) {
+      try {
+        sql::PreparedStatement *prep_stmt = conn->prepareStatement("INSERT INTO perfTestTextBatch(t0) VALUES (?)");
+        for (int64_t i = 0; i < state.range(0); i++) {
+          prep_stmt->setString(1, value);
+          prep_stmt->addBatch();
+        }
+        prep_stmt->executeBatch();
+        delete prep_stmt;
+      } catch(sql::SQLException& e){
+        state.SkipWithError(e.what());
+      }
+    }
+
+    void run_insert_batch_sized(benchmark::State& state, const std::string& options) {
+      sql::Connection *conn = connect(options);
+      std::string value = randomString(100);
+      int numOperation = 0;
+      for (auto _ : state) {
+        insert_batch_sized(state, conn, value);
+        numOperation++;
+      }
+      state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+      state.SetItemsProcessed(static_cast<int64_t>(numOperation) * state.range(0));
+      delete conn;
+    }
+
+    // Client side prepared statement - every row is a text protocol query
+    static void BM_BATCH_TEXT(benchmark::State& state) {
+      run_insert_batch_sized(state, "");
+    }
 
+    // Client side prepared statement, rows rewritten into multi-value INSERT
+    static void BM_BATCH_TEXT_REWRITE(benchmark::State& state) {
+      run_insert_batch_sized(state, "?rewriteBatchedStatements=true");
+    }
+
+    // Server side prepared statement, executed for every row
+    static void BM_BATCH_BINARY(benchmark::State& state) {
+      run_insert_batch_sized(state, "?useServerPrepStmts=true&useBulkStmts=false");
+    }
+
+    // Server side prepared statement, all rows sent in one COM_STMT_BULK_EXECUTE
+    static void BM_BATCH_BULK(benchmark::State& state) {
+      run_insert_batch_sized(state, "?useServerPrepStmts=true&useBulkStmts=true");
+    }
+
+    BENCHMARK(BM_BATCH_TEXT)->Name(TYPE + " batch - text")->Arg(10)->Arg(100)->Arg(1000)->UseRealTime()->Setup(setup_insert_batch);
+    BENCHMARK(BM_BATCH_TEXT_REWRITE)->Name(TYPE + " batch - text rewrite")->Arg(10)->Arg(100)->Arg(1000)->UseRealTime()->Setup(setup_insert_batch);
+    BENCHMARK(BM_BATCH_BINARY)->Name(TYPE + " batch - binary")->Arg(10)->Arg(100)->Arg(1000)->UseRealTime()->Setup(setup_insert_batch);
+    BENCHMARK(BM_BATCH_BULK)->Name(TYPE + " batch - bulk")->Arg(10)->Arg(100)->Arg(1000)->UseRealTime()->Setup(setup_insert_batch);
+#endif
+
+// Driver name is added to the context of JSON output, so files of different runs and releases can be told apart
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::AddCustomContext("driver", TYPE);
+  benchmark::AddCustomContext("host", DB_HOST + ":" + DB_PORT);
+  benchmark::AddCustomContext("max_threads", std::to_string(MAX_THREAD));
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
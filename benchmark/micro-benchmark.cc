@@ -0,0 +1,442 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (c) 2026 MariaDB Corporation plc
+
+/* Server-less micro benchmarks of driver internals on the hot path of every query: row getters, query parsing,
+ * escaping, parameters serialization, column lookup by name and the prepared statements cache. Rows are synthetic, thus
+ * no server is needed. Builds with connector's internal headers and static library, see README.md
+ */
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "options/DefaultOptions.h"
+#include "ColumnDefinition.h"
+#include "ColumnType.h"
+#include "com/ColumnNameMap.h"
+#include "protocol/capi/TextRowProtocolCapi.h"
+#include "protocol/capi/BinRowProtocolCapi.h"
+#include "util/ClientPrepareResult.h"
+#include "util/Utils.h"
+#include "parameters/BigDecimalParameter.h"
+#include "parameters/BooleanParameter.h"
+#include "parameters/ByteArrayParameter.h"
+#include "parameters/ByteParameter.h"
+#include "parameters/DateParameter.h"
+#include "parameters/DefaultParameter.h"
+#include "parameters/DoubleParameter.h"
+#include "parameters/FloatParameter.h"
+#include "parameters/IntParameter.h"
+#include "parameters/LongParameter.h"
+#include "parameters/NullParameter.h"
+#include "parameters/ReaderParameter.h"
+#include "parameters/ShortParameter.h"
+#include "parameters/StreamParameter.h"
+#include "parameters/StringParameter.h"
+#include "parameters/TimeParameter.h"
+#include "parameters/TimestampParameter.h"
+#include "parameters/ULongParameter.h"
+#include "lru/lrucache.h"
+
+using namespace sql::mariadb;
+
+const int MAX_THREAD = 64;
+
+/* Every heap allocation made by a thread is counted, to report allocations per operation */
+static thread_local uint64_t allocations = 0;
+
+void* operator new(std::size_t size) {
+  ++allocations;
+  void* ptr = std::malloc(size != 0 ? size : 1);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+class AllocationCounter {
+  uint64_t start;
+public:
+  AllocationCounter() : start(allocations) {}
+
+  void report(benchmark::State& state) {
+    state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocations - start),
+      benchmark::Counter::kAvgIterations);
+  }
+};
+
+Shared::Options& options() {
+  static Shared::Options opts = DefaultOptions::defaultValues(HaMode::NONE);
+  return opts;
+}
+
+/* One column of each type getters are benchmarked on, in the order of enum Getter */
+enum Getter { GET_INT = 0, GET_LONG, GET_DOUBLE, GET_STRING, GET_BIGDECIMAL, GET_TIMESTAMP, GET_DATE, GETTERS };
+
+/* Column definition refers to its name, hence names have to live as long as columns do */
+std::vector<Shared::ColumnDefinition>& rowColumns() {
+  static std::vector<sql::SQLString> names{ "i", "l", "d", "s", "n", "ts", "dt" };
+  static std::vector<Shared::ColumnDefinition> columns = {
+    ColumnDefinition::create(names[GET_INT], ColumnType::INTEGER),
+    ColumnDefinition::create(names[GET_LONG], ColumnType::BIGINT),
+    ColumnDefinition::create(names[GET_DOUBLE], ColumnType::DOUBLE),
+    ColumnDefinition::create(names[GET_STRING], ColumnType::VARCHAR),
+    ColumnDefinition::create(names[GET_BIGDECIMAL], ColumnType::DECIMAL),
+    ColumnDefinition::create(names[GET_TIMESTAMP], ColumnType::DATETIME),
+    ColumnDefinition::create(names[GET_DATE], ColumnType::DATE)
+  };
+  return columns;
+}
+
+void callGetter(RowProtocol& row, Getter getter) {
+  ColumnDefinition* column = rowColumns()[getter].get();
+  row.setPosition(getter);
+
+  switch (getter) {
+  case GET_INT:
+    benchmark::DoNotOptimize(row.getInternalInt(column));
+    break;
+  case GET_LONG:
+    benchmark::DoNotOptimize(row.getInternalLong(column));
+    break;
+  case GET_DOUBLE:
+    benchmark::DoNotOptimize(row.getInternalDouble(column));
+    break;
+  case GET_STRING:
+    benchmark::DoNotOptimize(row.getInternalString(column));
+    break;
+  case GET_BIGDECIMAL:
+    benchmark::DoNotOptimize(row.getInternalBigDecimal(column));
+    break;
+  case GET_TIMESTAMP:
+    benchmark::DoNotOptimize(row.getInternalTimestamp(column));
+    break;
+  case GET_DATE:
+    benchmark::DoNotOptimize(row.getInternalDate(column));
+    break;
+  default:
+    break;
+  }
+}
+
+/* Text protocol row. TextRowProtocolCapi reads the field from the same buffer whether the row comes from MYSQL_ROW or
+ * from the row cache, and only the latter can be filled without a server */
+void BM_TEXT_ROW_GETTER(benchmark::State& state, Getter getter) {
+  std::vector<std::string> values = {
+    "123456", "-922337203685477", "3.141592653589793", "synthetic varchar value", "12345678.9012",
+    "2026-10-19 12:34:56.123456", "2026-10-19"
+  };
+  std::vector<sql::bytes> row;
+  for (auto& value : values) {
+    row.emplace_back(value.c_str(), value.length());
+  }
+  capi::TextRowProtocolCapi protocol(0, options(), nullptr);
+  protocol.resetRow(row);
+
+  AllocationCounter counter;
+  for (auto _ : state) {
+    callGetter(protocol, getter);
+  }
+  counter.report(state);
+}
+
+/* Binary protocol row on a statement handle, which is marked as prepared, without talking to a server, only to let the
+ * row bind its result buffers. Benchmark then writes synthetic values straight into those MYSQL_BIND buffers */
+class SyntheticStatement {
+  capi::MYSQL* connection;
+public:
+  capi::MYSQL_STMT* stmt;
+
+  SyntheticStatement(unsigned int fieldCount)
+    : connection(capi::mysql_init(nullptr))
+    , stmt(capi::mysql_stmt_init(connection)) {
+    stmt->state = capi::MYSQL_STMT_PREPARED;
+    stmt->field_count = fieldCount;
+  }
+
+  ~SyntheticStatement() {
+    stmt->state = capi::MYSQL_STMT_INITTED;
+    capi::mysql_stmt_close(stmt);
+    capi::mysql_close(connection);
+  }
+
+  template <typename T> void set(std::size_t column, const T& value) {
+    std::memcpy(stmt->bind[column].buffer, &value, sizeof(T));
+    *stmt->bind[column].length = sizeof(T);
+    *stmt->bind[column].is_null = 0;
+  }
+
+  void set(std::size_t column, const std::string& value) {
+    std::memcpy(stmt->bind[column].buffer, value.c_str(), value.length());
+    *stmt->bind[column].length = static_cast<unsigned long>(value.length());
+    *stmt->bind[column].is_null = 0;
+  }
+};
+
+void BM_BIN_ROW_GETTER(benchmark::State& state, Getter getter) {
+  std::vector<Shared::ColumnDefinition>& columns = rowColumns();
+  SyntheticStatement statement(static_cast<unsigned int>(columns.size()));
+  capi::BinRowProtocolCapi protocol(columns, static_cast<int32_t>(columns.size()), 0, options(), statement.stmt);
+  capi::MYSQL_TIME timestamp = {2026, 10, 19, 12, 34, 56, 123456, 0, capi::MYSQL_TIMESTAMP_DATETIME};
+  capi::MYSQL_TIME date = {2026, 10, 19, 0, 0, 0, 0, 0, capi::MYSQL_TIMESTAMP_DATE};
+
+  statement.set(GET_INT, static_cast<int32_t>(123456));
+  statement.set(GET_LONG, static_cast<int64_t>(-922337203685477LL));
+  statement.set(GET_DOUBLE, 3.141592653589793);
+  statement.set(GET_STRING, std::string("synthetic varchar value"));
+  /* The column created for the synthetic row has 1 byte buffer, which is enough for a short decimal only */
+  statement.set(GET_BIGDECIMAL, std::string("1"));
+  statement.set(GET_TIMESTAMP, timestamp);
+  statement.set(GET_DATE, date);
+
+  AllocationCounter counter;
+  for (auto _ : state) {
+    callGetter(protocol, getter);
+  }
+  counter.report(state);
+}
+
+#define ROW_GETTER_BENCHMARKS(func) \
+  BENCHMARK_CAPTURE(func, int, GET_INT); \
+  BENCHMARK_CAPTURE(func, long, GET_LONG); \
+  BENCHMARK_CAPTURE(func, double, GET_DOUBLE); \
+  BENCHMARK_CAPTURE(func, string, GET_STRING); \
+  BENCHMARK_CAPTURE(func, bigdecimal, GET_BIGDECIMAL); \
+  BENCHMARK_CAPTURE(func, timestamp, GET_TIMESTAMP); \
+  BENCHMARK_CAPTURE(func, date, GET_DATE)
+
+ROW_GETTER_BENCHMARKS(BM_TEXT_ROW_GETTER);
+ROW_GETTER_BENCHMARKS(BM_BIN_ROW_GETTER);
+
+const sql::SQLString SIMPLE_QUERY("SELECT * FROM bench_table WHERE id = ? AND name = ?");
+const sql::SQLString INSERT_QUERY("INSERT INTO bench_table /* comment with ? */ (id, name, val, t) "
+  "VALUES (?, 'it''s a \"literal\" with ?', ?, ?) -- trailing comment");
+
+void BM_PARAMETER_PARTS(benchmark::State& state, const sql::SQLString& query) {
+  AllocationCounter counter;
+  for (auto _ : state) {
+    std::unique_ptr<ClientPrepareResult> result(ClientPrepareResult::parameterParts(query, false));
+    benchmark::DoNotOptimize(result.get());
+  }
+  counter.report(state);
+}
+BENCHMARK_CAPTURE(BM_PARAMETER_PARTS, select, SIMPLE_QUERY);
+BENCHMARK_CAPTURE(BM_PARAMETER_PARTS, insert, INSERT_QUERY);
+
+void BM_REWRITABLE_PARTS(benchmark::State& state, const sql::SQLString& query) {
+  AllocationCounter counter;
+  for (auto _ : state) {
+    std::unique_ptr<ClientPrepareResult> result(ClientPrepareResult::rewritableParts(query, false));
+    benchmark::DoNotOptimize(result.get());
+  }
+  counter.report(state);
+}
+BENCHMARK_CAPTURE(BM_REWRITABLE_PARTS, select, SIMPLE_QUERY);
+BENCHMARK_CAPTURE(BM_REWRITABLE_PARTS, insert, INSERT_QUERY);
+
+/* Data of given size with a quote, a backslash and a zero byte in every 64 bytes */
+std::string dataToEscape(std::size_t size) {
+  std::string data;
+  data.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    switch (i % 64) {
+    case 7:  data.push_back('\''); break;
+    case 23: data.push_back('\\'); break;
+    case 41: data.push_back('\0'); break;
+    default: data.push_back(static_cast<char>('a' + i % 26));
+    }
+  }
+  return data;
+}
+
+void BM_ESCAPE_DATA(benchmark::State& state) {
+  std::string data = dataToEscape(static_cast<std::size_t>(state.range(0)));
+  bool noBackslashEscapes = state.range(1) != 0;
+  sql::SQLString out;
+
+  AllocationCounter counter;
+  for (auto _ : state) {
+    out.clear();
+    Utils::escapeData(data.c_str(), data.length(), noBackslashEscapes, out);
+    benchmark::DoNotOptimize(out.c_str());
+  }
+  counter.report(state);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_ESCAPE_DATA)->ArgNames({"size", "noBackslashEscapes"})
+  ->Args({64, 0})->Args({4096, 0})->Args({4096, 1})->Args({1024*1024, 0});
+
+/* nativeSql needs the protocol only for backslashes in literals and for CONVERT to DOUBLE, which the queries avoid */
+void BM_NATIVE_SQL(benchmark::State& state, const sql::SQLString& query) {
+  AllocationCounter counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Utils::nativeSql(query, nullptr));
+  }
+  counter.report(state);
+}
+BENCHMARK_CAPTURE(BM_NATIVE_SQL, no_escape, SIMPLE_QUERY);
+BENCHMARK_CAPTURE(BM_NATIVE_SQL, escapes, sql::SQLString(
+  "SELECT {fn CONCAT(name, 'x')}, {fn UCASE(name)} FROM bench_table WHERE d > {d '2026-10-19'} "
+  "AND t < {ts '2026-10-19 12:34:56'} AND {fn CONVERT(id, SQL_BIGINT)} = ?"));
+
+ParameterHolder* newBigDecimal() { return new BigDecimalParameter("12345678.9012"); }
+ParameterHolder* newBoolean() { return new BooleanParameter(true); }
+ParameterHolder* newByteArray() {
+  std::string data = dataToEscape(1024);
+  return new ByteArrayParameter(sql::bytes(data.c_str(), data.length()), false);
+}
+ParameterHolder* newByte() { return new ByteParameter(-42); }
+ParameterHolder* newDate() { return new DateParameter("2026-10-19", nullptr, options()); }
+ParameterHolder* newDefault() { return new DefaultParameter(); }
+ParameterHolder* newDouble() { return new DoubleParameter(3.141592653589793L); }
+ParameterHolder* newFloat() { return new FloatParameter(3.1415927f); }
+ParameterHolder* newInt() { return new IntParameter(123456); }
+ParameterHolder* newLong() { return new LongParameter(-922337203685477LL); }
+ParameterHolder* newULong() { return new ULongParameter(18446744073709551615ULL); }
+ParameterHolder* newNull() { return new NullParameter(); }
+ParameterHolder* newShort() { return new ShortParameter(-1234); }
+ParameterHolder* newString() { return new StringParameter(sql::SQLString(dataToEscape(1024).c_str()), false); }
+ParameterHolder* newTime() { return new TimeParameter("12:34:56.123456", nullptr, true); }
+ParameterHolder* newTimestamp() { return new TimestampParameter("2026-10-19 12:34:56.123456", nullptr, true); }
+
+void BM_PARAMETER_WRITETO(benchmark::State& state, ParameterHolder* (*factory)()) {
+  std::unique_ptr<ParameterHolder> parameter(factory());
+  sql::SQLString query;
+
+  AllocationCounter counter;
+  for (auto _ : state) {
+    query.clear();
+    parameter->writeTo(query);
+    benchmark::DoNotOptimize(query.c_str());
+  }
+  counter.report(state);
+}
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, BigDecimal, newBigDecimal);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, Boolean, newBoolean);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, ByteArray_1K, newByteArray);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, Byte, newByte);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, Date, newDate);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, Default, newDefault);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, Double, newDouble);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, Float, newFloat);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, Int, newInt);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, Long, newLong);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, ULong, newULong);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, Null, newNull);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, Short, newShort);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, String_1K, newString);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, Time, newTime);
+BENCHMARK_CAPTURE(BM_PARAMETER_WRITETO, Timestamp, newTimestamp);
+
+/* ReaderParameter is not cloned by the driver, and leaves the bits of binary protocol unimplemented */
+class BenchReaderParameter : public ReaderParameter {
+public:
+  using ReaderParameter::ReaderParameter;
+  void* getValuePtr() { return nullptr; }
+  unsigned long getValueBinLen() const { return 0; }
+  ParameterHolder* clone() { return nullptr; }
+};
+
+/* Stream parameters consume their stream, thus it is rewound before each write */
+template <class StreamParameterType> void BM_STREAM_PARAMETER_WRITETO(benchmark::State& state) {
+  std::istringstream stream(dataToEscape(static_cast<std::size_t>(state.range(0))));
+  StreamParameterType parameter(stream, state.range(0), false);
+  sql::SQLString query;
+
+  AllocationCounter counter;
+  for (auto _ : state) {
+    stream.clear();
+    stream.seekg(0);
+    query.clear();
+    parameter.writeTo(query);
+    benchmark::DoNotOptimize(query.c_str());
+  }
+  counter.report(state);
+}
+BENCHMARK_TEMPLATE(BM_STREAM_PARAMETER_WRITETO, StreamParameter)->Arg(1024)->Arg(64*1024);
+BENCHMARK_TEMPLATE(BM_STREAM_PARAMETER_WRITETO, BenchReaderParameter)->Arg(1024)->Arg(64*1024);
+
+void BM_COLUMN_NAME_INDEX(benchmark::State& state) {
+  const int columnCount = static_cast<int>(state.range(0));
+  std::vector<Shared::ColumnDefinition> columns;
+  std::vector<sql::SQLString> names;
+
+  for (int i = 0; i < columnCount; ++i) {
+    names.emplace_back(("column_" + std::to_string(i)).c_str());
+  }
+  for (auto& name : names) {
+    columns.push_back(ColumnDefinition::create(name, ColumnType::INTEGER));
+  }
+  ColumnNameMap columnNameMap(columns);
+  /* Labels are looked up case insensitively, upper case ones make sure nothing is skipped on the lowering */
+  std::vector<sql::SQLString> labels(names);
+  for (auto& label : labels) {
+    label.toUpperCase();
+  }
+  std::size_t next = 0;
+
+  AllocationCounter counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(columnNameMap.getIndex(labels[next]));
+    if (++next == labels.size()) {
+      next = 0;
+    }
+  }
+  counter.report(state);
+}
+BENCHMARK(BM_COLUMN_NAME_INDEX)->ArgName("columns")->Arg(10)->Arg(100);
+
+/* Cache stores pointers to values it doesn't own */
+struct KeepValue {
+  void operator()(int*) {}
+};
+
+const std::size_t CACHE_SIZE = 250;
+/* Twice more statements than the cache holds, so part of lookups miss and replace the eldest entry */
+const std::size_t CACHE_KEYS = 2*CACHE_SIZE;
+
+std::vector<std::string> cacheKeys() {
+  std::vector<std::string> keys;
+  for (std::size_t i = 0; i < CACHE_KEYS; ++i) {
+    keys.push_back("SELECT * FROM bench_table WHERE id = ? AND val = " + std::to_string(i));
+  }
+  return keys;
+}
+
+void BM_LRU_CACHE(benchmark::State& state) {
+  static ::mariadb::LruCache<std::string, int, KeepValue> cache(CACHE_SIZE);
+  static const std::vector<std::string> keys = cacheKeys();
+  static int value = 0;
+
+  /* Skewed access - 3 of 4 lookups are done in the first quarter of keys */
+  std::size_t next = static_cast<std::size_t>(state.thread_index())*7;
+
+  AllocationCounter counter;
+  for (auto _ : state) {
+    const std::string& key = keys[(next & 3) != 0 ? next % (CACHE_KEYS / 4) : next % CACHE_KEYS];
+    if (cache.get(key) == nullptr) {
+      cache.put(key, &value);
+    }
+    next += 13;
+  }
+  counter.report(state);
+}
+BENCHMARK(BM_LRU_CACHE)->ThreadRange(1, MAX_THREAD)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,303 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (c) 2026 MariaDB Corporation plc
+
+/* Driver's protocol layer - queries, result sets, prepared statements, batches and pool - against the in-process stub
+ * server(stub-server.h). No database is needed, and results do not depend on server's load. Batch, connect and pool
+ * validation also run through latency-proxy.h, with 1ms and 10ms round trip time, see README.md
+ */
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <mariadb/conncpp.hpp>
+
+#include "stub-server.h"
+#include "latency-proxy.h"
+
+#define OPERATION_PER_SECOND_LABEL "nb operations per second"
+
+std::string GetEnvironmentVariableOrDefault(const std::string& variable_name,
+                                            const std::string& default_value)
+{
+    const char* value = getenv(variable_name.c_str());
+    return value ? value : default_value;
+}
+
+// Benchmarks run on 1, 2, 4 ... MAX_THREAD threads. Set TEST_MAX_THREAD=1 for single thread run
+const int MAX_THREAD = std::stoi(GetEnvironmentVariableOrDefault("TEST_MAX_THREAD", "64"));
+const std::string TYPE = "MariaDB stub";
+
+// Stub servers by their response delay in microseconds. Created before benchmarks run, and not changed afterwards
+std::map<int64_t, std::unique_ptr<stub::StubServer>> servers;
+
+// Latency proxies in front of the stub server without delay, by round trip time in microseconds
+std::map<int64_t, std::unique_ptr<proxy::LatencyProxy>> proxies;
+
+stub::StubServer& server(int64_t latencyUs = 0) {
+  return *servers.at(latencyUs);
+}
+
+// Port to connect to, to have given round trip time
+uint16_t portWithRtt(int64_t rttUs) {
+  return rttUs == 0 ? server().getPort() : proxies.at(rttUs)->getPort();
+}
+
+void startServer(int64_t latencyUs) {
+  stub::Config config;
+  config.latency = std::chrono::microseconds(latencyUs);
+  std::unique_ptr<stub::StubServer> stubServer(new stub::StubServer(config));
+
+  stubServer->on("SELECT rows_1 ", stub::Response::result(stub::ResultSet::generate(1, 2, 32)));
+  stubServer->on("SELECT rows_1000 ", stub::Response::result(stub::ResultSet::generate(1000, 2, 32)));
+  stubServer->on("SELECT rows_100000 ", stub::Response::result(stub::ResultSet::generate(100000, 2, 32)));
+  servers[latencyUs] = std::move(stubServer);
+}
+
+void startProxy(int64_t rttUs) {
+  proxies[rttUs].reset(new proxy::LatencyProxy(proxy::Config::withRtt(server().getPort(), std::chrono::microseconds(rttUs))));
+}
+
+sql::Connection* connect(const std::string& options, uint16_t port = 0) {
+  try {
+    sql::Driver *driver = sql::mariadb::get_driver_instance();
+    return driver->connect("tcp://127.0.0.1:" + std::to_string(port != 0 ? port : server().getPort()) + "/bench" + options,
+      "stub", "");
+  } catch(sql::SQLException& e){
+    std::cerr << "Error Connecting to the stub server: " << e.what() << std::endl;
+    exit(1);
+  }
+}
+
+void do_1(benchmark::State& state, sql::Connection* conn) {
+  try {
+    std::unique_ptr<sql::Statement> stmt(conn->createStatement());
+    stmt->executeUpdate("DO 1");
+  } catch(sql::SQLException& e){
+    state.SkipWithError(e.what());
+  }
+}
+
+// state.range(0) is the stub's response delay in microseconds
+static void BM_DO_1(benchmark::State& state) {
+  sql::Connection *conn = connect("", server(state.range(0)).getPort());
+  int numOperation = 0;
+  for (auto _ : state) {
+    do_1(state, conn);
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+  delete conn;
+}
+
+BENCHMARK(BM_DO_1)->Name(TYPE + " DO 1")->ArgName("latency_us")->Arg(0)->Arg(100)->ThreadRange(1, MAX_THREAD)->UseRealTime();
+
+int64_t read_rows(benchmark::State& state, sql::ResultSet* res) {
+  int64_t rows = 0;
+  int val1;
+  sql::SQLString val2;
+  while (res->next()) {
+    benchmark::DoNotOptimize(val1 = res->getInt(1));
+    benchmark::DoNotOptimize(val2 = res->getString(2));
+    benchmark::ClobberMemory();
+    ++rows;
+  }
+  return rows;
+}
+
+void select_rows(benchmark::State& state, sql::Connection* conn, int fetchSize) {
+  try {
+    std::unique_ptr<sql::Statement> stmt(conn->createStatement());
+    if (fetchSize > 0) {
+      stmt->setFetchSize(fetchSize);
+    }
+    std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT rows_" + std::to_string(state.range(0)) + " "));
+    read_rows(state, res.get());
+  } catch(sql::SQLException& e){
+    state.SkipWithError(e.what());
+  }
+}
+
+// state.range(0) is the number of rows
+static void BM_SELECT_ROWS(benchmark::State& state) {
+  sql::Connection *conn = connect("");
+  int numOperation = 0;
+  for (auto _ : state) {
+    select_rows(state, conn, 0);
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+  state.SetItemsProcessed(static_cast<int64_t>(numOperation) * state.range(0));
+  delete conn;
+}
+
+BENCHMARK(BM_SELECT_ROWS)->Name(TYPE + " SELECT rows")->ArgName("rows")->Arg(1)->Arg(1000)->Arg(100000)->ThreadRange(1, MAX_THREAD)->UseRealTime();
+
+// state.range(0) is the fetch size
+static void BM_SELECT_ROWS_STREAMING(benchmark::State& state) {
+  sql::Connection *conn = connect("");
+  int numOperation = 0;
+  for (auto _ : state) {
+    try {
+      std::unique_ptr<sql::Statement> stmt(conn->createStatement());
+      stmt->setFetchSize(static_cast<int32_t>(state.range(0)));
+      std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT rows_100000 "));
+      read_rows(state, res.get());
+    } catch(sql::SQLException& e){
+      state.SkipWithError(e.what());
+    }
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+  delete conn;
+}
+
+BENCHMARK(BM_SELECT_ROWS_STREAMING)->Name(TYPE + " SELECT 100000 rows - streaming")->ArgName("fetch")->Arg(100)->Arg(10000)->ThreadRange(1, MAX_THREAD)->UseRealTime();
+
+static void BM_SELECT_ROWS_SRV_PREPARED(benchmark::State& state) {
+  sql::Connection *conn = connect("?useServerPrepStmts=true");
+  std::unique_ptr<sql::PreparedStatement> prep(conn->prepareStatement("SELECT rows_1000 FROM bench WHERE id > ?"));
+  int numOperation = 0;
+  for (auto _ : state) {
+    try {
+      prep->setInt(1, 0);
+      std::unique_ptr<sql::ResultSet> res(prep->executeQuery());
+      read_rows(state, res.get());
+    } catch(sql::SQLException& e){
+      state.SkipWithError(e.what());
+    }
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+  prep.reset();
+  delete conn;
+}
+
+BENCHMARK(BM_SELECT_ROWS_SRV_PREPARED)->Name(TYPE + " SELECT 1000 rows - srv prepared")->ThreadRange(1, MAX_THREAD)->UseRealTime();
+
+// ------------------------------ batch: text vs binary vs bulk ------------------------------
+
+// state.range(0) is the batch size, state.range(1) is the round trip time in microseconds
+void run_batch(benchmark::State& state, const std::string& options) {
+  sql::Connection *conn = connect(options, portWithRtt(state.range(1)));
+  const std::string value(100, 'a');
+  int numOperation = 0;
+  for (auto _ : state) {
+    try {
+      std::unique_ptr<sql::PreparedStatement> prep(conn->prepareStatement("INSERT INTO bench(t0) VALUES (?)"));
+      for (int64_t i = 0; i < state.range(0); i++) {
+        prep->setString(1, value);
+        prep->addBatch();
+      }
+      prep->executeBatch();
+    } catch(sql::SQLException& e){
+      state.SkipWithError(e.what());
+    }
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+  state.SetItemsProcessed(static_cast<int64_t>(numOperation) * state.range(0));
+  delete conn;
+}
+
+static void BM_BATCH_TEXT(benchmark::State& state) {
+  run_batch(state, "");
+}
+
+static void BM_BATCH_TEXT_REWRITE(benchmark::State& state) {
+  run_batch(state, "?rewriteBatchedStatements=true");
+}
+
+static void BM_BATCH_BINARY(benchmark::State& state) {
+  run_batch(state, "?useServerPrepStmts=true&useBulkStmts=false");
+}
+
+static void BM_BATCH_BULK(benchmark::State& state) {
+  run_batch(state, "?useServerPrepStmts=true&useBulkStmts=true");
+}
+
+static void BatchArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"batch", "rtt_us"})->Args({100, 0})->Args({1000, 0})->Args({100, 1000})->Args({100, 10000});
+}
+
+BENCHMARK(BM_BATCH_TEXT)->Name(TYPE + " batch - text")->Apply(BatchArgs)->UseRealTime();
+BENCHMARK(BM_BATCH_TEXT_REWRITE)->Name(TYPE + " batch - text rewrite")->Apply(BatchArgs)->UseRealTime();
+BENCHMARK(BM_BATCH_BINARY)->Name(TYPE + " batch - binary")->Apply(BatchArgs)->UseRealTime();
+BENCHMARK(BM_BATCH_BULK)->Name(TYPE + " batch - bulk")->Apply(BatchArgs)->UseRealTime();
+
+// ------------------------------ connection establishment and pool checkout ------------------------------
+
+// state.range(0) is the round trip time in microseconds
+static void BM_CONNECT(benchmark::State& state) {
+  const uint16_t port = portWithRtt(state.range(0));
+  int numOperation = 0;
+  for (auto _ : state) {
+    delete connect("", port);
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_CONNECT)->Name(TYPE + " connect")->ArgName("rtt_us")->Arg(0)->Arg(1000)->Arg(10000)->ThreadRange(1, MAX_THREAD)->UseRealTime();
+
+// Pool has a connection for each thread, checkout validates the connection and giving it back resets it
+static void BM_POOL_CHECKOUT(benchmark::State& state) {
+  const std::string poolOptions = "?pool=true&minPoolSize=" + std::to_string(MAX_THREAD) + "&maxPoolSize=" + std::to_string(MAX_THREAD);
+  delete connect(poolOptions);
+  int numOperation = 0;
+  for (auto _ : state) {
+    sql::Connection *conn = connect(poolOptions);
+    do_1(state, conn);
+    delete conn;
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_POOL_CHECKOUT)->Name(TYPE + " pool checkout + DO 1")->ThreadRange(1, MAX_THREAD)->UseRealTime();
+
+// Checkout validating the connection every time(poolValidMinDelay=0) - with COM_PING, or locally by
+// poolLocalValidation. state.range(0) is poolLocalValidation, state.range(1) is the round trip time in microseconds.
+// Only the checkout is timed. Connection is given back without reset(the stub server has no session tracking, so
+// every return would cost a COM_RESET_CONNECTION round trip), and stays idle longer than 1 ms, so the validation is
+// not skipped because of poolValidMinDelay's millisecond rounding
+static void BM_POOL_VALIDATION(benchmark::State& state) {
+  const std::string poolOptions = "?pool=true&minPoolSize=" + std::to_string(MAX_THREAD) + "&maxPoolSize=" + std::to_string(MAX_THREAD)
+    + "&useResetConnection=false&poolValidMinDelay=0&poolLocalValidation=" + (state.range(0) != 0 ? "true" : "false");
+  const uint16_t port = portWithRtt(state.range(1));
+  delete connect(poolOptions, port);
+  int numOperation = 0;
+  for (auto _ : state) {
+    sql::Connection *conn = connect(poolOptions, port);
+    state.PauseTiming();
+    delete conn;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    state.ResumeTiming();
+    numOperation++;
+  }
+  state.counters[OPERATION_PER_SECOND_LABEL] = benchmark::Counter(numOperation, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_POOL_VALIDATION)->Name(TYPE + " pool checkout - validation")->ArgNames({"local", "rtt_us"})
+  ->ArgsProduct({{0, 1}, {0, 1000, 10000}})->ThreadRange(1, MAX_THREAD)->UseRealTime();
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  startServer(0);
+  startServer(100);
+  startProxy(1000);
+  startProxy(10000);
+  benchmark::AddCustomContext("driver", TYPE);
+  benchmark::AddCustomContext("max_threads", std::to_string(MAX_THREAD));
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  proxies.clear();
+  servers.clear();
+  return 0;
+}
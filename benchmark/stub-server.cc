@@ -0,0 +1,836 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (c) 2026 MariaDB Corporation plc
+
+#include "stub-server.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+
+#include "bench-socket.h"
+
+namespace stub
+{
+/* Column definitions and rows, in text and binary protocol, as packet payloads */
+struct EncodedResultSet
+{
+  std::vector<std::string> columnDefinitions;
+  std::vector<std::string> textRows;
+  std::vector<std::string> binaryRows;
+};
+
+namespace
+{
+const uint8_t COM_QUIT= 0x01, COM_INIT_DB= 0x02, COM_QUERY= 0x03, COM_PING= 0x0e, COM_CHANGE_USER= 0x11,
+  COM_STMT_PREPARE= 0x16, COM_STMT_EXECUTE= 0x17, COM_STMT_SEND_LONG_DATA= 0x18, COM_STMT_CLOSE= 0x19,
+  COM_STMT_RESET= 0x1a, COM_SET_OPTION= 0x1b, COM_RESET_CONNECTION= 0x1f, COM_STMT_BULK_EXECUTE= 0xfa;
+
+const uint32_t CLIENT_LONG_FLAG= 4, CLIENT_CONNECT_WITH_DB= 8, CLIENT_PROTOCOL_41= 512, CLIENT_TRANSACTIONS= 8192,
+  CLIENT_SECURE_CONNECTION= 32768, CLIENT_MULTI_STATEMENTS= 1UL << 16, CLIENT_MULTI_RESULTS= 1UL << 17,
+  CLIENT_PS_MULTI_RESULTS= 1UL << 18, CLIENT_PLUGIN_AUTH= 1UL << 19;
+const uint32_t SERVER_CAPABILITIES= CLIENT_LONG_FLAG | CLIENT_CONNECT_WITH_DB | CLIENT_PROTOCOL_41 |
+  CLIENT_TRANSACTIONS | CLIENT_SECURE_CONNECTION | CLIENT_MULTI_STATEMENTS | CLIENT_MULTI_RESULTS |
+  CLIENT_PS_MULTI_RESULTS | CLIENT_PLUGIN_AUTH;
+/* MariaDB extended capabilities. Client reads them from the handshake, since CLIENT_MYSQL(bit 0) is not set */
+const uint32_t MARIADB_CLIENT_STMT_BULK_OPERATIONS= 1UL << 2;
+
+const uint16_t SERVER_STATUS_AUTOCOMMIT= 2, SERVER_MORE_RESULTS_EXIST= 8;
+const uint16_t STMT_BULK_FLAG_SEND_TYPES= 128;
+const uint8_t TYPE_VAR_STRING= 253, CHARSET_UTF8MB4= 45;
+const uint8_t BULK_INDICATOR_NONE= 0;
+const std::size_t MAX_PACKET_PAYLOAD= 0xffffff;
+const char SCRAMBLE[]= "stubserverscramble12";
+
+void int1(std::string& buf, uint64_t value)
+{
+  buf.push_back(static_cast<char>(value & 0xff));
+}
+
+void intN(std::string& buf, uint64_t value, int bytes)
+{
+  for (int i= 0; i < bytes; ++i) {
+    int1(buf, value >> (8*i));
+  }
+}
+
+void lenencInt(std::string& buf, uint64_t value)
+{
+  if (value < 251) {
+    int1(buf, value);
+  }
+  else if (value < 0x10000) {
+    int1(buf, 0xfc);
+    intN(buf, value, 2);
+  }
+  else if (value < 0x1000000) {
+    int1(buf, 0xfd);
+    intN(buf, value, 3);
+  }
+  else {
+    int1(buf, 0xfe);
+    intN(buf, value, 8);
+  }
+}
+
+void lenencStr(std::string& buf, const std::string& str)
+{
+  lenencInt(buf, str.length());
+  buf.append(str);
+}
+
+uint64_t readInt(const std::string& buf, std::size_t pos, int bytes)
+{
+  uint64_t value= 0;
+  for (int i= 0; i < bytes && pos + i < buf.length(); ++i) {
+    value|= static_cast<uint64_t>(static_cast<uint8_t>(buf[pos + i])) << (8*i);
+  }
+  return value;
+}
+
+/* Reads length encoded integer at pos, and moves pos past it */
+uint64_t readLenencInt(const std::string& buf, std::size_t& pos)
+{
+  uint8_t first= static_cast<uint8_t>(buf[pos++]);
+  int bytes= first == 0xfc ? 2 : first == 0xfd ? 3 : first == 0xfe ? 8 : 0;
+  uint64_t value= bytes == 0 ? first : readInt(buf, pos, bytes);
+  pos+= bytes;
+  return value;
+}
+
+std::string columnDefinition(const std::string& name, uint64_t maxLength)
+{
+  std::string def;
+  lenencStr(def, "def");
+  lenencStr(def, "");
+  lenencStr(def, "");
+  lenencStr(def, "");
+  lenencStr(def, name);
+  lenencStr(def, name);
+  int1(def, 0x0c);
+  intN(def, CHARSET_UTF8MB4, 2);
+  intN(def, std::max<uint64_t>(maxLength, 1)*4, 4);
+  int1(def, TYPE_VAR_STRING);
+  intN(def, 0, 2);
+  int1(def, 0);
+  intN(def, 0, 2);
+  return def;
+}
+
+std::string lowerCase(const std::string& str)
+{
+  std::string result(str);
+  std::transform(result.begin(), result.end(), result.begin(),
+    [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+  return result;
+}
+
+std::string trimLeft(const std::string& str)
+{
+  std::size_t start= 0;
+  while (start < str.length() && std::isspace(static_cast<unsigned char>(str[start]))) {
+    ++start;
+  }
+  return str.substr(start);
+}
+
+/* Splits multi-statement query on semicolons outside of literals and comments, and counts '?' placeholders */
+std::vector<std::string> splitStatements(const std::string& query, uint16_t& placeholders)
+{
+  enum { NORMAL, QUOTE, LINE_COMMENT, BLOCK_COMMENT } state= NORMAL;
+  char quote= '\0';
+  std::vector<std::string> statements;
+  std::string current;
+
+  placeholders= 0;
+  for (std::size_t i= 0; i < query.length(); ++i) {
+    char c= query[i];
+    char next= i + 1 < query.length() ? query[i + 1] : '\0';
+
+    switch (state) {
+    case NORMAL:
+      if (c == '\'' || c == '"' || c == '`') {
+        state= QUOTE;
+        quote= c;
+      }
+      else if (c == '#' || (c == '-' && next == '-')) {
+        state= LINE_COMMENT;
+      }
+      else if (c == '/' && next == '*') {
+        state= BLOCK_COMMENT;
+      }
+      else if (c == '?') {
+        ++placeholders;
+      }
+      else if (c == ';') {
+        if (!trimLeft(current).empty()) {
+          statements.push_back(current);
+        }
+        current.clear();
+        continue;
+      }
+      break;
+    case QUOTE:
+      if (c == '\\' && quote != '`' && next != '\0') {
+        current.push_back(c);
+        c= query[++i];
+      }
+      else if (c == quote) {
+        state= NORMAL;
+      }
+      break;
+    case LINE_COMMENT:
+      if (c == '\n') {
+        state= NORMAL;
+      }
+      break;
+    case BLOCK_COMMENT:
+      if (c == '*' && next == '/') {
+        current.push_back(c);
+        c= next;
+        ++i;
+        state= NORMAL;
+      }
+      break;
+    }
+    current.push_back(c);
+  }
+  if (!trimLeft(current).empty()) {
+    statements.push_back(current);
+  }
+  return statements;
+}
+
+bool startsWith(const std::string& str, const std::string& prefix)
+{
+  return str.compare(0, prefix.length(), prefix) == 0;
+}
+
+/* Length of the binary protocol value of the type at pos */
+std::size_t binaryValueLength(const std::string& buf, std::size_t pos, uint8_t type)
+{
+  if (pos >= buf.length()) {
+    return 0;
+  }
+  switch (type) {
+  case 6: /* NULL */
+    return 0;
+  case 1: /* TINY */
+    return 1;
+  case 2: /* SHORT */
+  case 13: /* YEAR */
+    return 2;
+  case 3: /* LONG */
+  case 4: /* FLOAT */
+  case 9: /* INT24 */
+    return 4;
+  case 5: /* DOUBLE */
+  case 8: /* LONGLONG */
+    return 8;
+  case 7: /* TIMESTAMP */
+  case 10: /* DATE */
+  case 11: /* TIME */
+  case 12: /* DATETIME */
+    return 1 + static_cast<uint8_t>(buf[pos]);
+  default:
+  {
+    std::size_t valuePos= pos;
+    uint64_t length= readLenencInt(buf, valuePos);
+    return static_cast<std::size_t>(valuePos - pos + length);
+  }
+  }
+}
+
+struct PreparedStatement
+{
+  Response response;
+  uint16_t params;
+  /* Parameter types of the last bulk execution. Client sends them only when they change */
+  std::vector<uint8_t> bulkTypes;
+};
+
+/* One client connection - packets framing and the command loop */
+class Connection
+{
+  StubServer& server;
+  std::atomic<uint64_t>& commands;
+  socket_t socket;
+  uint32_t id;
+  uint8_t sequence= 0;
+  uint16_t status= SERVER_STATUS_AUTOCOMMIT;
+  std::string out;
+  uint32_t nextStatementId= 1;
+  std::map<uint32_t, PreparedStatement> statements;
+
+  bool readFully(char* buf, std::size_t length)
+  {
+    while (length > 0) {
+      int received= ::recv(socket, buf, static_cast<int>(length), 0);
+      if (received <= 0) {
+        return false;
+      }
+      buf+= received;
+      length-= static_cast<std::size_t>(received);
+    }
+    return true;
+  }
+
+  bool readPacket(std::string& payload)
+  {
+    payload.clear();
+    std::size_t length;
+    do {
+      char header[4];
+      if (!readFully(header, sizeof(header))) {
+        return false;
+      }
+      length= static_cast<std::size_t>(readInt(std::string(header, 3), 0, 3));
+      sequence= static_cast<uint8_t>(header[3] + 1);
+      std::size_t offset= payload.length();
+      payload.resize(offset + length);
+      if (length > 0 && !readFully(&payload[offset], length)) {
+        return false;
+      }
+    } while (length == MAX_PACKET_PAYLOAD);
+    return true;
+  }
+
+  void packet(const std::string& payload)
+  {
+    std::size_t offset= 0;
+    std::size_t length;
+    do {
+      length= std::min(payload.length() - offset, MAX_PACKET_PAYLOAD);
+      intN(out, length, 3);
+      int1(out, sequence++);
+      out.append(payload, offset, length);
+      offset+= length;
+    } while (length == MAX_PACKET_PAYLOAD);
+  }
+
+  void flush()
+  {
+    bench::sendAll(socket, out.data(), out.length());
+    out.clear();
+  }
+
+  void delay()
+  {
+    if (server.getConfig().latency.count() > 0) {
+      std::this_thread::sleep_for(server.getConfig().latency);
+    }
+  }
+
+  void ok(uint64_t affectedRows, uint16_t moreResults= 0)
+  {
+    std::string payload;
+    int1(payload, 0x00);
+    lenencInt(payload, affectedRows);
+    lenencInt(payload, 0);
+    intN(payload, status | moreResults, 2);
+    intN(payload, 0, 2);
+    packet(payload);
+  }
+
+  void eof(uint16_t moreResults= 0)
+  {
+    std::string payload;
+    int1(payload, 0xfe);
+    intN(payload, 0, 2);
+    intN(payload, status | moreResults, 2);
+    packet(payload);
+  }
+
+  void error(uint16_t code, const std::string& sqlState, const std::string& message)
+  {
+    std::string payload;
+    int1(payload, 0xff);
+    intN(payload, code, 2);
+    payload.push_back('#');
+    payload.append((sqlState + "00000").substr(0, 5));
+    payload.append(message);
+    packet(payload);
+  }
+
+  void resultSet(const EncodedResultSet& rs, bool binary, uint16_t moreResults= 0)
+  {
+    std::string count;
+    lenencInt(count, rs.columnDefinitions.size());
+    packet(count);
+    for (auto& column : rs.columnDefinitions) {
+      packet(column);
+    }
+    eof();
+    for (auto& row : binary ? rs.binaryRows : rs.textRows) {
+      packet(row);
+      /* Sending rows as they come, not to hold whole big result set in the buffer */
+      if (out.length() > 64*1024) {
+        flush();
+      }
+    }
+    eof(moreResults);
+  }
+
+  /* Writes the response. Returns false if it was an error, that stops the multi-statement */
+  bool respond(const Response& response, bool binary, uint16_t moreResults= 0)
+  {
+    switch (response.type) {
+    case Response::OK:
+      ok(response.affectedRows, moreResults);
+      return true;
+    case Response::ERROR:
+      error(response.errorCode, response.sqlState, response.message);
+      return false;
+    case Response::RESULT_SET:
+      resultSet(*response.resultSet, binary, moreResults);
+      return true;
+    }
+    return true;
+  }
+
+  void trackAutocommit(const std::string& statement)
+  {
+    std::string lower(lowerCase(trimLeft(statement)));
+    if (!startsWith(lower, "set autocommit")) {
+      return;
+    }
+    std::size_t valuePos= lower.find_first_not_of(" =", std::strlen("set autocommit"));
+    if (valuePos != std::string::npos) {
+      if (lower[valuePos] == '0' || startsWith(lower.substr(valuePos), "off")) {
+        status&= ~SERVER_STATUS_AUTOCOMMIT;
+      }
+      else {
+        status|= SERVER_STATUS_AUTOCOMMIT;
+      }
+    }
+  }
+
+  void handshake()
+  {
+    std::string payload;
+    int1(payload, 10);
+    payload.append(server.getConfig().serverVersion).push_back('\0');
+    intN(payload, id, 4);
+    payload.append(SCRAMBLE, 8).push_back('\0');
+    intN(payload, SERVER_CAPABILITIES & 0xffff, 2);
+    int1(payload, CHARSET_UTF8MB4);
+    intN(payload, status, 2);
+    intN(payload, SERVER_CAPABILITIES >> 16, 2);
+    int1(payload, sizeof(SCRAMBLE));
+    payload.append(6, '\0');
+    intN(payload, MARIADB_CLIENT_STMT_BULK_OPERATIONS, 4);
+    payload.append(SCRAMBLE + 8, sizeof(SCRAMBLE) - 8);
+    payload.append("mysql_native_password").push_back('\0');
+    packet(payload);
+    flush();
+  }
+
+  void query(const std::string& sql)
+  {
+    uint16_t placeholders;
+    std::vector<std::string> statements(splitStatements(sql, placeholders));
+
+    if (statements.empty()) {
+      error(1065, "42000", "Query was empty");
+      return;
+    }
+    for (std::size_t i= 0; i < statements.size(); ++i) {
+      trackAutocommit(statements[i]);
+      if (!respond(server.respond(statements[i]), false, i + 1 < statements.size() ? SERVER_MORE_RESULTS_EXIST : 0)) {
+        break;
+      }
+    }
+  }
+
+  void prepare(const std::string& sql)
+  {
+    uint16_t placeholders;
+    std::vector<std::string> parts(splitStatements(sql, placeholders));
+    if (parts.size() != 1) {
+      error(1064, "42000", parts.empty() ? "Query was empty" : "Multi-statements can't be prepared");
+      return;
+    }
+    PreparedStatement& stmt= statements[nextStatementId];
+    stmt.response= server.respond(parts.front());
+    stmt.params= placeholders;
+
+    const std::vector<std::string>* columns= stmt.response.type == Response::RESULT_SET ?
+      &stmt.response.resultSet->columnDefinitions : nullptr;
+    std::string payload;
+    int1(payload, 0x00);
+    intN(payload, nextStatementId++, 4);
+    intN(payload, columns ? columns->size() : 0, 2);
+    intN(payload, placeholders, 2);
+    int1(payload, 0);
+    intN(payload, 0, 2);
+    packet(payload);
+
+    if (placeholders > 0) {
+      std::string param(columnDefinition("?", 0));
+      for (uint16_t i= 0; i < placeholders; ++i) {
+        packet(param);
+      }
+      eof();
+    }
+    if (columns && !columns->empty()) {
+      for (auto& column : *columns) {
+        packet(column);
+      }
+      eof();
+    }
+  }
+
+  PreparedStatement* findStatement(const std::string& payload)
+  {
+    auto it= statements.find(static_cast<uint32_t>(readInt(payload, 1, 4)));
+    if (it == statements.end()) {
+      error(1243, "HY000", "Unknown prepared statement handler given to mysqld_stmt_execute");
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  /* Counts rows of the bulk, to report them as affected */
+  uint64_t bulkRows(PreparedStatement& stmt, const std::string& payload)
+  {
+    std::size_t pos= 5;
+    uint16_t flags= static_cast<uint16_t>(readInt(payload, pos, 2));
+    pos+= 2;
+    if ((flags & STMT_BULK_FLAG_SEND_TYPES) != 0) {
+      stmt.bulkTypes.clear();
+      for (uint16_t i= 0; i < stmt.params; ++i, pos+= 2) {
+        stmt.bulkTypes.push_back(static_cast<uint8_t>(payload[pos]));
+      }
+    }
+    if (stmt.bulkTypes.size() != stmt.params || stmt.params == 0) {
+      return 1;
+    }
+    uint64_t rows= 0;
+    while (pos < payload.length()) {
+      for (uint8_t type : stmt.bulkTypes) {
+        if (pos >= payload.length()) {
+          return rows;
+        }
+        if (static_cast<uint8_t>(payload[pos++]) == BULK_INDICATOR_NONE) {
+          pos+= binaryValueLength(payload, pos, type);
+        }
+      }
+      ++rows;
+    }
+    return rows;
+  }
+
+public:
+  Connection(StubServer& server, std::atomic<uint64_t>& commands, socket_t socket, uint32_t id)
+    : server(server), commands(commands), socket(socket), id(id) {}
+
+  void run()
+  {
+    std::string payload;
+
+    handshake();
+    if (!readPacket(payload)) {
+      return;
+    }
+    ok(0);
+    flush();
+
+    while (readPacket(payload) && !payload.empty()) {
+      uint8_t command= static_cast<uint8_t>(payload[0]);
+      sequence= 1;
+      ++commands;
+
+      switch (command) {
+      case COM_QUIT:
+        return;
+      case COM_STMT_SEND_LONG_DATA:
+        continue;
+      case COM_STMT_CLOSE:
+        statements.erase(static_cast<uint32_t>(readInt(payload, 1, 4)));
+        continue;
+      default:
+        break;
+      }
+
+      delay();
+      switch (command) {
+      case COM_INIT_DB:
+      case COM_PING:
+      case COM_CHANGE_USER:
+        ok(0);
+        break;
+      case COM_RESET_CONNECTION:
+        statements.clear();
+        status= SERVER_STATUS_AUTOCOMMIT;
+        ok(0);
+        break;
+      case COM_SET_OPTION:
+        eof();
+        break;
+      case COM_QUERY:
+        query(payload.substr(1));
+        break;
+      case COM_STMT_PREPARE:
+        prepare(payload.substr(1));
+        break;
+      case COM_STMT_EXECUTE:
+        if (PreparedStatement* stmt= findStatement(payload)) {
+          respond(stmt->response, true);
+        }
+        break;
+      case COM_STMT_RESET:
+        if (findStatement(payload)) {
+          ok(0);
+        }
+        break;
+      case COM_STMT_BULK_EXECUTE:
+        if (PreparedStatement* stmt= findStatement(payload)) {
+          if (stmt->response.type == Response::ERROR) {
+            respond(stmt->response, true);
+          }
+          else {
+            ok(bulkRows(*stmt, payload));
+          }
+        }
+        break;
+      default:
+        error(1047, "08S01", "Unknown command");
+      }
+      flush();
+    }
+  }
+};
+}
+
+
+ResultSet ResultSet::generate(uint32_t rows, uint32_t columns, uint32_t valueSize)
+{
+  ResultSet rs;
+  for (uint32_t c= 1; c <= columns; ++c) {
+    rs.columns.push_back("c" + std::to_string(c));
+  }
+  rs.rows.reserve(rows);
+  /* Zero padded row numbers, so values can be read with getInt() as well as with getString() */
+  for (uint32_t r= 1; r <= rows; ++r) {
+    std::string number(std::to_string(r));
+    std::string value(number.length() < valueSize ? std::string(valueSize - number.length(), '0') + number :
+      number.substr(number.length() - valueSize));
+    rs.rows.emplace_back(columns, value);
+  }
+  return rs;
+}
+
+
+Response Response::ok(uint64_t affectedRows)
+{
+  Response response;
+  response.type= OK;
+  response.affectedRows= affectedRows;
+  response.errorCode= 0;
+  return response;
+}
+
+
+Response Response::error(uint16_t errorCode, const std::string& message, const std::string& sqlState)
+{
+  Response response(ok());
+  response.type= ERROR;
+  response.errorCode= errorCode;
+  response.sqlState= sqlState;
+  response.message= message;
+  return response;
+}
+
+
+Response Response::result(const ResultSet& rs)
+{
+  std::shared_ptr<EncodedResultSet> encoded(new EncodedResultSet());
+  std::vector<std::size_t> maxLength(rs.columns.size(), 0);
+  const std::size_t nullBitmapLength= (rs.columns.size() + 7 + 2) / 8;
+
+  for (auto& row : rs.rows) {
+    if (row.size() != rs.columns.size()) {
+      throw std::invalid_argument("Row size differs from the number of columns");
+    }
+    std::string text, binary;
+    int1(binary, 0x00);
+    binary.append(nullBitmapLength, '\0');
+    for (std::size_t c= 0; c < row.size(); ++c) {
+      lenencStr(text, row[c]);
+      lenencStr(binary, row[c]);
+      maxLength[c]= std::max(maxLength[c], row[c].length());
+    }
+    encoded->textRows.push_back(std::move(text));
+    encoded->binaryRows.push_back(std::move(binary));
+  }
+  for (std::size_t c= 0; c < rs.columns.size(); ++c) {
+    encoded->columnDefinitions.push_back(columnDefinition(rs.columns[c], maxLength[c]));
+  }
+
+  Response response(ok());
+  response.type= RESULT_SET;
+  response.resultSet= encoded;
+  return response;
+}
+
+
+StubServer::StubServer(const Config& _config, uint16_t _port)
+  : config(_config)
+  , defaultResult(Response::result(ResultSet::generate(_config.rows, _config.columns, _config.valueSize)))
+  , listenSocket(static_cast<int64_t>(INVALID_SOCKET))
+  , port(_port)
+{
+  static bench::SocketsInit socketsInit;
+  ResultSet sessionVariables;
+  sessionVariables.columns= { "@@max_allowed_packet", "@@system_time_zone", "@@time_zone", "@@auto_increment_increment",
+    "@@wait_timeout", "@@tx_isolation" };
+  sessionVariables.rows= { { "16777216", "UTC", "SYSTEM", "1", "28800", "REPEATABLE-READ" } };
+
+  ResultSet showVariables;
+  showVariables.columns= { "Variable_name", "Value" };
+  for (std::size_t i= 0; i < sessionVariables.columns.size(); ++i) {
+    showVariables.rows.push_back({ sessionVariables.columns[i].substr(2), sessionVariables.rows[0][i] });
+  }
+  ResultSet readOnly;
+  readOnly.columns= { "@@innodb_read_only" };
+  readOnly.rows= { { "0" } };
+  ResultSet galeraState;
+  galeraState.columns= { "Variable_name", "Value" };
+  galeraState.rows= { { "wsrep_local_state", "4" } };
+  // Read by the pool to compare idle time with. Without it the default result would give wait_timeout of 1 second
+  ResultSet waitTimeout;
+  waitTimeout.columns= { "@@wait_timeout" };
+  waitTimeout.rows= { { "28800" } };
+
+  builtinRules.push_back({ "select @@max_allowed_packet", Response::result(sessionVariables) });
+  builtinRules.push_back({ "show variables", Response::result(showVariables) });
+  builtinRules.push_back({ "select @@innodb_read_only", Response::result(readOnly) });
+  builtinRules.push_back({ "select @@wait_timeout", Response::result(waitTimeout) });
+  builtinRules.push_back({ "show status like 'wsrep_local_state'", Response::result(galeraState) });
+
+  socket_t listener= bench::listenLocal(port);
+  if (listener == INVALID_SOCKET) {
+    throw std::runtime_error("Stub server could not listen on port " + std::to_string(_port));
+  }
+  listenSocket= static_cast<int64_t>(listener);
+  acceptor= std::thread(&StubServer::acceptLoop, this);
+}
+
+
+StubServer::~StubServer()
+{
+  stop();
+}
+
+
+void StubServer::on(const std::string& prefix, const Response& response)
+{
+  std::lock_guard<std::mutex> guard(rulesLock);
+  rules.push_back({ lowerCase(trimLeft(prefix)), response });
+}
+
+
+Response StubServer::respond(const std::string& statement)
+{
+  std::string lower(lowerCase(trimLeft(statement)));
+  {
+    std::lock_guard<std::mutex> guard(rulesLock);
+    for (auto& rule : rules) {
+      if (startsWith(lower, rule.prefix)) {
+        return rule.response;
+      }
+    }
+  }
+  for (auto& rule : builtinRules) {
+    if (startsWith(lower, rule.prefix)) {
+      return rule.response;
+    }
+  }
+  for (auto prefix : { "select", "show", "with", "values", "desc", "explain", "check", "analyze" }) {
+    if (startsWith(lower, prefix)) {
+      return defaultResult;
+    }
+  }
+  for (auto prefix : { "insert", "update", "delete", "replace" }) {
+    if (startsWith(lower, prefix)) {
+      return Response::ok(1);
+    }
+  }
+  return Response::ok(0);
+}
+
+
+void StubServer::acceptLoop()
+{
+  while (!stopped.load()) {
+    socket_t accepted= ::accept(static_cast<socket_t>(listenSocket), nullptr, nullptr);
+    if (accepted == INVALID_SOCKET) {
+      if (stopped.load()) {
+        break;
+      }
+      continue;
+    }
+    bench::setNoDelay(accepted);
+
+    std::lock_guard<std::mutex> guard(clientsLock);
+    /* Reaping threads of closed connections, benchmarks of connect would pile them up otherwise */
+    for (auto it= clients.begin(); it != clients.end();) {
+      if ((*it)->done.load()) {
+        (*it)->thread.join();
+        it= clients.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+    if (stopped.load()) {
+      CLOSE_SOCKET(accepted);
+      break;
+    }
+    clients.emplace_back(new Client());
+    Client* client= clients.back().get();
+    client->socket= static_cast<int64_t>(accepted);
+    client->thread= std::thread(&StubServer::serve, this, client);
+  }
+}
+
+
+void StubServer::serve(Client* client)
+{
+  Connection connection(*this, commands, static_cast<socket_t>(client->socket), nextConnectionId++);
+  connection.run();
+  /* Under the lock, so stop() doesn't shut down the socket after it's closed */
+  std::lock_guard<std::mutex> guard(clientsLock);
+  CLOSE_SOCKET(static_cast<socket_t>(client->socket));
+  client->done.store(true);
+}
+
+
+void StubServer::stop()
+{
+  if (stopped.exchange(true)) {
+    return;
+  }
+  ::shutdown(static_cast<socket_t>(listenSocket), SHUT_RDWR);
+  CLOSE_SOCKET(static_cast<socket_t>(listenSocket));
+  if (acceptor.joinable()) {
+    acceptor.join();
+  }
+
+  std::vector<std::unique_ptr<Client>> closing;
+  {
+    std::lock_guard<std::mutex> guard(clientsLock);
+    closing.swap(clients);
+    for (auto& client : closing) {
+      if (!client->done.load()) {
+        ::shutdown(static_cast<socket_t>(client->socket), SHUT_RDWR);
+      }
+    }
+  }
+  for (auto& client : closing) {
+    client->thread.join();
+  }
+}
+
+}
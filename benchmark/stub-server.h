@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// Copyright (c) 2026 MariaDB Corporation plc
+
+/* In-process scripted stub of a MariaDB server. Listens on a local TCP port and speaks enough of the client/server
+ * protocol for the driver to connect and run text and binary protocol queries, batches and pings, returning canned
+ * results of configurable size after a configurable delay. Permits to benchmark and stress the driver without a
+ * database, and without the noise the server adds.
+ *
+ * Served commands are the handshake with mysql_native_password authentication(any credentials are accepted),
+ * COM_QUERY(multi-statements included), COM_STMT_PREPARE, COM_STMT_EXECUTE, COM_STMT_BULK_EXECUTE, COM_STMT_CLOSE,
+ * COM_STMT_RESET, COM_STMT_SEND_LONG_DATA, COM_PING, COM_RESET_CONNECTION, COM_INIT_DB, COM_SET_OPTION and COM_QUIT.
+ * Other commands get an error. There is no SSL, compression, cursors or session tracking.
+ */
+#ifndef _STUB_SERVER_H_
+#define _STUB_SERVER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace stub
+{
+
+/* Result set with string columns. Values are sent as VARCHAR, the driver converts them on getInt() etc */
+struct ResultSet
+{
+  std::vector<std::string> columns;
+  std::vector<std::vector<std::string>> rows;
+
+  /* rows x columns result set, every value is valueSize characters long */
+  static ResultSet generate(uint32_t rows, uint32_t columns, uint32_t valueSize);
+};
+
+/* Result set in wire format, encoded once when the response is created */
+struct EncodedResultSet;
+
+/* Response the stub gives to a statement - OK, error, or a result set */
+struct Response
+{
+  enum Type { OK, ERROR, RESULT_SET };
+
+  Type type;
+  uint64_t affectedRows;
+  uint16_t errorCode;
+  std::string sqlState;
+  std::string message;
+  std::shared_ptr<const EncodedResultSet> resultSet;
+
+  static Response ok(uint64_t affectedRows= 0);
+  static Response error(uint16_t errorCode, const std::string& message, const std::string& sqlState= "HY000");
+  static Response result(const ResultSet& resultSet);
+};
+
+struct Config
+{
+  /* Result set returned by SELECT, SHOW and other queries returning rows, that no rule matches */
+  uint32_t rows= 1;
+  uint32_t columns= 1;
+  uint32_t valueSize= 8;
+  /* Delay before each response, to emulate server's processing time */
+  std::chrono::microseconds latency{0};
+  std::string serverVersion= "11.4.2-MariaDB-stub";
+};
+
+class StubServer
+{
+  struct Rule
+  {
+    std::string prefix;
+    Response response;
+  };
+  struct Client
+  {
+    int64_t socket;
+    std::thread thread;
+    std::atomic<bool> done{false};
+  };
+
+  const Config config;
+  const Response defaultResult;
+  int64_t listenSocket;
+  uint16_t port;
+  std::thread acceptor;
+  std::atomic<bool> stopped{false};
+  std::atomic<uint64_t> commands{0};
+  std::atomic<uint32_t> nextConnectionId{1};
+
+  std::mutex rulesLock;
+  std::vector<Rule> rules;
+  /* Answers to the queries the driver sends on connect */
+  std::vector<Rule> builtinRules;
+
+  std::mutex clientsLock;
+  std::vector<std::unique_ptr<Client>> clients;
+
+  void acceptLoop();
+  void serve(Client* client);
+
+public:
+  /* Starts listening on 127.0.0.1. With port 0 a free port is picked, see getPort() */
+  explicit StubServer(const Config& config= Config(), uint16_t port= 0);
+  ~StubServer();
+
+  StubServer(const StubServer&)= delete;
+  StubServer& operator=(const StubServer&)= delete;
+
+  uint16_t getPort() const { return port; }
+  const Config& getConfig() const { return config; }
+  /* Number of commands served so far */
+  uint64_t getCommandCount() const { return commands.load(); }
+
+  /* Statements starting with the prefix(case insensitive, leading whitespaces skipped) get the response. Rules are
+   * matched in the order they have been added, before the stub's defaults */
+  void on(const std::string& prefix, const Response& response);
+  /* Response to the statement, i.e. matching rule's one, or the default */
+  Response respond(const std::string& statement);
+  /* Closes listening socket and all connections, and joins their threads */
+  void stop();
+};
+
+}
+#endif
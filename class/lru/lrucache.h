@@ -24,6 +24,7 @@
 #include <unordered_map>
 #include <list>
 #include <mutex>
+#include <vector>
 
 
 namespace mariadb
@@ -36,6 +37,7 @@ namespace mariadb
     virtual VT* put(const KT& key, VT* obj2cache) {return nullptr;}
     virtual VT* get(const KT& key) {return nullptr;}
     virtual void clear() {}
+    virtual std::vector<KT> keys() {return std::vector<KT>();}
   };
 
   template <class T> struct DefaultRemover
@@ -126,6 +128,24 @@ namespace mariadb
     }
 
 
+    /* Keys of cached objects, most recently used first */
+    virtual std::vector<KT> keys()
+    {
+      std::lock_guard<std::mutex> localScopeLock(lock);
+      std::vector<KT> result;
+
+      result.reserve(cache.size());
+      for (auto& entry : lu)
+      {
+        if (entry.second != nullptr)
+        {
+          result.push_back(entry.first);
+        }
+      }
+      return result;
+    }
+
+
     virtual void clear()
     {
       std::lock_guard<std::mutex> localScopeLock(lock);
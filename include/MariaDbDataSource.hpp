@@ -29,6 +29,88 @@ namespace mariadb
 {
 class MariaDbDataSourceInternal;
 
+/**
+ * Distribution of durations with power of 2 microseconds buckets: bucket 0 counts durations below 1us, bucket i
+ * durations in [2^(i-1), 2^i) us. The last bucket also counts everything above.
+ */
+struct PoolHistogram
+{
+  static const int32_t BUCKETS= 32;
+
+  int64_t count= 0;
+  int64_t totalMicros= 0;
+  int64_t maxMicros= 0;
+  int64_t buckets[BUCKETS]= {0};
+
+  /** Upper bound in microseconds of the bucket, where the given fraction(0..1) of durations falls */
+  int64_t percentile(double fraction) const
+  {
+    int64_t threshold= static_cast<int64_t>(fraction*count), seen= 0;
+    if (count == 0) {
+      return 0;
+    }
+    for (int32_t i= 0; i < BUCKETS; ++i) {
+      seen+= buckets[i];
+      if (seen > threshold || seen == count) {
+        return i == BUCKETS - 1 ? maxMicros : (static_cast<int64_t>(1) << i);
+      }
+    }
+    return maxMicros;
+  }
+};
+
+/**
+ * Priority class of the request for a pooled connection. When the pool is exhausted, waiting requests get
+ * connections in FIFO order within a class, and higher class requests are served first.
+ */
+enum class PoolPriority : int32_t
+{
+  HIGH= 0,
+  NORMAL= 1,
+  LOW= 2
+};
+
+/** Snapshot of the connections pool counters and timings */
+struct PoolStatistics
+{
+  int64_t totalConnections= 0;
+  int64_t activeConnections= 0;
+  int64_t idleConnections= 0;
+  int64_t pendingRequests= 0;
+  /* Size the pool maintains: minPoolSize, or the demand based size with poolAdaptiveSizing */
+  int64_t targetConnections= 0;
+
+  int64_t connectionsCreated= 0;
+  int64_t connectionsCreationFailed= 0;
+  int64_t connectionsClosed= 0;
+  /* Local socket checks of idle connections, and how many of them found the connection closed */
+  int64_t socketChecks= 0;
+  int64_t socketChecksFailed= 0;
+  /* Idle connections discarded, as they have been idle longer than server's wait_timeout */
+  int64_t expiredByAge= 0;
+  /* Idle connections accepted after local checks, without COM_PING */
+  int64_t pingsAvoided= 0;
+  /* COM_PING validations, and how many of them failed */
+  int64_t validations= 0;
+  int64_t validationsFailed= 0;
+  /* Requests that have not found idle connection right away, and had to wait */
+  int64_t acquiresWaited= 0;
+  int64_t acquiresTimedOut= 0;
+  /* Requests failed right away with poolFailFast, as the expected wait exceeded connectTimeout */
+  int64_t acquiresRejected= 0;
+
+  /* Time getConnection() has taken */
+  PoolHistogram acquireTime;
+  /* Time connection has been in use by the application */
+  PoolHistogram holdTime;
+  /* Time to establish new physical connection */
+  PoolHistogram connectTime;
+  /* Time spent in COM_PING validation */
+  PoolHistogram validationTime;
+  /* Time spent resetting connection state, when it's given back to the pool */
+  PoolHistogram resetTime;
+};
+
 #pragma warning(push)
 #pragma warning(disable:4251)
 
@@ -52,6 +134,9 @@ public:
   SQLString getUrl();
   Connection* getConnection();  
   Connection* getConnection(const SQLString& username,const SQLString& password);  
+  /** With the pool, requests connection with the given priority. Without the pool priority is ignored */
+  Connection* getConnection(PoolPriority priority);
+  Connection* getConnection(const SQLString& username, const SQLString& password, PoolPriority priority);
   PrintWriter* getLogWriter();  
   void setLogWriter(const PrintWriter& out);  
   int32_t getLoginTimeout();  
@@ -63,6 +148,11 @@ public:
   sql::Logger* getParentLogger();
   /** Close datasource - this closes corresponding connections pool */
   void close();
+  /**
+   * Fills statistics of the connections pool of the datasource.
+   * @return false if the pool has not been created yet, or has been closed
+   */
+  bool getPoolStatistics(PoolStatistics& statistics);
 };
 
 }
@@ -67,14 +67,16 @@ namespace mariadb
     *
     * @param urlParser parser
     * @param globalInfo global info
+    * @param priority priority of the request to the pool, if pool option is set
     * @return connection object
     * @throws SQLException if any connection error occur
     */
-  MariaDbConnection* MariaDbConnection::newConnection(Shared::UrlParser &urlParser, GlobalStateInfo *globalInfo)
+  MariaDbConnection* MariaDbConnection::newConnection(Shared::UrlParser &urlParser, GlobalStateInfo *globalInfo,
+    PoolPriority priority)
   {
     if (urlParser->getOptions()->pool)
     {
-      return dynamic_cast<MariaDbConnection*>(Pools::retrievePool(urlParser)->getPoolConnection()->getConnection());
+      return dynamic_cast<MariaDbConnection*>(Pools::retrievePool(urlParser)->getPoolConnection(priority)->getConnection());
     }
     Shared::Protocol protocol(Utils::retrieveProxy(urlParser, globalInfo));
 
@@ -734,8 +736,13 @@ namespace mariadb
 
     if (stmt)
     {
+      const bool sessionStateChanged= protocol->isSessionStateChanged();
       stateFlag|= ConnectionState::STATE_AUTOCOMMIT;
       stmt->executeUpdate(SQLString("set autocommit=").append((autoCommit) ? '1' : '0'));
+      // Autocommit is restored without reset, server's report of this change does not make the session changed
+      if (!sessionStateChanged) {
+        protocol->setSessionStateChanged(false);
+      }
     }
   }
 
@@ -873,13 +880,14 @@ namespace mariadb
             append(" - set read-only to value ").append(std::to_string(readOnly));
       logger->debug(LogMsg);
 
+      // Protocol refuses the change inside a transaction, and then the state stays as it was
+      protocol->setReadonly(readOnly);
       if (readOnly) {
         stateFlag |= ConnectionState::STATE_READ_ONLY;
       }
       else {
         stateFlag &= ~static_cast<int32_t>(ConnectionState::STATE_READ_ONLY);
       }
-      protocol->setReadonly(readOnly);
     }
     catch (SQLException &e) {
       throw e;// ExceptionMapper.getException(e, this, NULL, false);
@@ -937,6 +945,11 @@ namespace mariadb
     */
   int32_t MariaDbConnection::getTransactionIsolation()
   {
+    // With session tracking the protocol gets all isolation level changes from the server
+    if (protocol->sessionStateAware() && protocol->getTransactionIsolationLevel() != 0)
+    {
+      return protocol->getTransactionIsolationLevel();
+    }
     Unique::Statement stmt(createStatement());
 
     SQLString sql("SELECT @@tx_isolation");
@@ -1170,8 +1183,33 @@ namespace mariadb
   }
   
 
-  SQLString MariaDbConnection::getClientOption(const SQLString& /*n*/) {
-    throw SQLFeatureNotSupportedException("getClientOption is not supported");
+  /**
+    * Returns connection traffic information. Supported names are:
+    * "compressionAlgorithm" - compression algorithm used by the connection, or empty string if it's not compressed
+    * "bytesReceived", "bytesSent" - number of bytes received from and sent to the server by this connection as they
+    *    went over the network, i.e. compressed if compression is used. Values are server-reported: they are the
+    *    server's session counters Bytes_sent and Bytes_received, read with SHOW SESSION STATUS. Connector/C does not
+    *    count the traffic. Thus each call costs a round trip, and the counters include the traffic of that query and
+    *    of earlier calls
+    *
+    * @param name - name of the value
+    * @return value as string
+    */
+  SQLString MariaDbConnection::getClientOption(const SQLString& name) {
+    if (name.compare("compressionAlgorithm") == 0) {
+      return protocol->getOptions()->useCompression ? "zlib" : "";
+    }
+    else if (name.compare("bytesReceived") == 0 || name.compare("bytesSent") == 0) {
+      // Server status is from the server's point of view
+      Unique::Statement st(createStatement());
+      Unique::ResultSet rs(st->executeQuery(name.compare("bytesReceived") == 0 ?
+        "SHOW SESSION STATUS LIKE 'Bytes_sent'" : "SHOW SESSION STATUS LIKE 'Bytes_received'"));
+      if (rs->next()) {
+        return rs->getString(2);
+      }
+      return "0";
+    }
+    throw SQLFeatureNotSupportedException("getClientOption is not supported for '" + name + "'");
   }
   /**
     * Constructs an object that implements the <code>Clob</code> interface. The object returned
@@ -1777,11 +1815,41 @@ namespace mariadb
     * @throws SQLException if resetting operation failed
     */
   void MariaDbConnection::reset()
+  {
+    reset(false);
+  }
+
+  /**
+    * Reset of the connection given back to the pool. With skipUnchangedReset option, COM_RESET_CONNECTION is
+    * skipped, if there is no open transaction, and the server has not reported session state changes. Autocommit and
+    * current database changed with Connection methods are restored without it.
+    *
+    * @throws SQLException if resetting operation failed
+    */
+  void MariaDbConnection::resetForReuse()
+  {
+    reset(options->skipUnchangedReset);
+  }
+
+
+  void MariaDbConnection::reset(bool skipComResetIfUnchanged)
   {
     bool useComReset=
       options->useResetConnection
       && ((protocol->isServerMariaDb() && protocol->versionGreaterOrEqual(10, 2, 4))
        || (!protocol->isServerMariaDb() && protocol->versionGreaterOrEqual(5, 7, 3)));
+
+    // Isolation level is restored with COM_RESET_CONNECTION only, since its default value is not known here
+    if (useComReset && skipComResetIfUnchanged && !protocol->isSessionStateChanged() && !protocol->inTransaction()
+      && (stateFlag & ConnectionState::STATE_TRANSACTION_ISOLATION) == 0) {
+      useComReset= false;
+      if (protocol->getAutocommit() != options->autocommit) {
+        stateFlag|= ConnectionState::STATE_AUTOCOMMIT;
+      }
+      if (protocol->getDatabase().compare(protocol->getUrlParser().getDatabase()) != 0) {
+        stateFlag|= ConnectionState::STATE_DATABASE;
+      }
+    }
     if (useComReset) {
       protocol->reset();
     }
@@ -29,6 +29,7 @@
 #include "Connection.hpp"
 #include "Statement.hpp"
 #include "Protocol.h"
+#include "MariaDbDataSource.hpp"
 
 #include "MariaDbPoolConnection.h"
 
@@ -84,9 +85,12 @@ private:
   bool warningsCleared= true;
   bool returnedToPool= false;
 
+  void reset(bool skipComResetIfUnchanged);
+
 public:
   MariaDbConnection(Shared::Protocol& protocol);
-  static MariaDbConnection* newConnection(Shared::UrlParser& urlParser, GlobalStateInfo* globalInfo);
+  static MariaDbConnection* newConnection(Shared::UrlParser& urlParser, GlobalStateInfo* globalInfo,
+    PoolPriority priority= PoolPriority::NORMAL);
   static SQLString quoteIdentifier(const SQLString& string);
   static SQLString unquoteIdentifier(SQLString& string);
   ~MariaDbConnection();
@@ -204,6 +208,7 @@ public:
   bool canUseServerTimeout();
   void setDefaultTransactionIsolation(int32_t defaultTransactionIsolation);
   void reset();
+  void resetForReuse();
   bool reconnect();
   bool includeDeadLockInfo();
   bool includeThreadsTraces();
@@ -127,12 +127,25 @@ namespace mariadb
    * @throws SQLException if a database access error occurs
    */
   Connection* MariaDbDataSource::getConnection()
+  {
+    return getConnection(PoolPriority::NORMAL);
+  }
+
+  /**
+   * Attempts to establish a connection with the data source that this <code>DataSource</code>
+   * object represents. If the pool is exhausted, the request waits after requests of the same or higher priority.
+   *
+   * @param priority priority of the request to the pool
+   * @return a connection to the data source
+   * @throws SQLException if a database access error occurs
+   */
+  Connection* MariaDbDataSource::getConnection(PoolPriority priority)
   {
     try {
       if (!internal->urlParser){
         internal->initialize();
       }
-      return MariaDbConnection::newConnection(internal->urlParser, nullptr);
+      return MariaDbConnection::newConnection(internal->urlParser, nullptr, priority);
     }
     catch (SQLException& e) {
       ExceptionFactory::INSTANCE.create(e, true);
@@ -151,6 +164,21 @@ namespace mariadb
    * @throws SQLException if a database access error occurs
    */
   Connection* MariaDbDataSource::getConnection(const SQLString& username,const SQLString& passwd)
+  {
+    return getConnection(username, passwd, PoolPriority::NORMAL);
+  }
+
+  /**
+   * Attempts to establish a connection with the data source that this <code>DataSource</code>
+   * object represents.
+   *
+   * @param username the database user on whose behalf the connection is being made
+   * @param password the user's password
+   * @param priority priority of the request to the pool
+   * @return a connection to the data source
+   * @throws SQLException if a database access error occurs
+   */
+  Connection* MariaDbDataSource::getConnection(const SQLString& username, const SQLString& passwd, PoolPriority priority)
   {
     try {
       if (!internal->urlParser){
@@ -162,7 +190,7 @@ namespace mariadb
       Shared::UrlParser urlParser(this->internal->urlParser->clone());
       internal->urlParser->setUsername(username);
       internal->urlParser->setPassword(passwd);
-      return MariaDbConnection::newConnection(urlParser, nullptr);
+      return MariaDbConnection::newConnection(urlParser, nullptr, priority);
 
     }
     catch (SQLException& e){
@@ -292,6 +320,20 @@ namespace mariadb
       pool->close();
   }
 
+  /** Extension to JDBC, statistics of the connections pool of the datasource */
+  bool MariaDbDataSource::getPoolStatistics(PoolStatistics& statistics)
+  {
+    if (!internal->urlParser) {
+      return false;
+    }
+    Shared::Pool pool= Pools::find(*internal->urlParser);
+    if (!pool) {
+      return false;
+    }
+    pool->getStatistics(statistics);
+    return true;
+  }
+
   // ------------------------- MariaDbDataSourceInternal ---------------------------
   /**
    * For testing purpose only.
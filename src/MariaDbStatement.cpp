@@ -43,6 +43,7 @@ namespace mariadb
   };
 
   Logger* MariaDbStatement::logger= LoggerFactory::getLogger(typeid(MariaDbStatement));
+
   /**
    * Creates a new Statement.
    *
@@ -66,6 +67,8 @@ namespace mariadb
       options(protocol->getOptions()),
       canUseServerTimeout(_connection->canUseServerTimeout()),
       exceptionFactory(factory),
+      timeoutTimer(std::bind(&MariaDbStatement::timeoutTask, this)),
+      timeoutState(new TimeoutTaskState()),
       isTimedout(false),
       queryTimeout(0),
       executing(false),
@@ -106,6 +109,7 @@ namespace mariadb
 
   MariaDbStatement::~MariaDbStatement()
   {
+    stopTimeoutTask();
     // We need to close associated resultset(the last one, previous should be closed once next result is requested)
     if (results) {
       results->loadFully(true, protocol.get()); //?
@@ -114,30 +118,57 @@ namespace mariadb
   }
 
   // Part of query prolog - setup timeout timer
-  void MariaDbStatement::setTimerTask(bool /*isBatch*/)
+  void MariaDbStatement::setTimerTask(bool isBatch)
+  {
+    timerForBatch= isBatch;
+    timerStarted= true;
+    TimerWheel::getInstance().schedule(timeoutTimer, std::chrono::seconds(queryTimeout));
+  }
+
+  /**
+   * Task of the timeout timer. Runs in the timer wheel thread, and only hands the kill of the query over to the
+   * executor.
+   */
+  void MariaDbStatement::timeoutTask()
   {
-#ifdef MAYBE_IN_NEXTVERSION
-    assert(!timerTaskFuture);
-    if (!timeoutScheduler)
+    std::shared_ptr<TimeoutTaskState> state(timeoutState);
     {
-      timeoutScheduler= SchedulerServiceProviderHolder::getTimeoutScheduler();
+      std::lock_guard<std::mutex> localScopeLock(state->lock);
+      state->stage= TimeoutTaskState::QUEUED;
+    }
+    // Kill of timed out query may need to connect, thus it runs in own thread, and not in the timer wheel's one
+    TimerWheel::getBackgroundExecutor("MariaDb-query-timeout", 4).execute([this, state]() {
+      {
+        std::lock_guard<std::mutex> localScopeLock(state->lock);
+        // Query has finished before the task started
+        if (state->stage != TimeoutTaskState::QUEUED) {
+          return;
+        }
+        state->stage= TimeoutTaskState::RUNNING;
+      }
+      killTimedOutQuery();
+      {
+        std::lock_guard<std::mutex> localScopeLock(state->lock);
+        state->stage= TimeoutTaskState::IDLE;
+      }
+      state->done.notify_all();
+    });
+  }
+
+  /**
+   * Kills the running query via separate connection, unless that is a batch, and interrupts the protocol.
+   */
+  void MariaDbStatement::killTimedOutQuery()
+  {
+    try {
+      isTimedout= true;
+      if (!timerForBatch) {
+        protocol->cancelCurrentQuery();
+      }
+      protocol->interrupt();
+    }
+    catch (std::exception&) {
     }
-    timerTaskFuture =
-      timeoutScheduler.schedule(
-          ()->{
-          try {
-          isTimedout= true;
-          if (!isBatch){
-          protocol->cancelCurrentQuery();
-          }
-          protocol->interrupt();
-          }catch (std::exception& e){
-
-          }
-          },
-          queryTimeout,
-          TimeUnit::SECONDS);
-#endif
   }
 
   /**
@@ -169,23 +200,17 @@ namespace mariadb
 
   void MariaDbStatement::stopTimeoutTask()
   {
-#ifdef MAYBE_IN_NEXTVERSION
-    if (timerTaskFuture){
-      if (!timerTaskFuture.cancel(true)){
-
-
-        try {
-          timerTaskFuture.get();
-        }catch (InterruptedException& e){
-
-          Thread.currentThread().interrupt();
-        }catch (InterruptedException& e){
-
-        }
+    if (timerStarted) {
+      // Waits for the timer's task, if it is running at the moment
+      TimerWheel::getInstance().cancel(timeoutTimer);
+      // Kill, that has not started yet, is not needed anymore. The one that is running is waited for
+      std::unique_lock<std::mutex> localScopeLock(timeoutState->lock);
+      if (timeoutState->stage == TimeoutTaskState::QUEUED) {
+        timeoutState->stage= TimeoutTaskState::IDLE;
       }
-      timerTaskFuture= nullptr;
+      timeoutState->done.wait(localScopeLock, [this]() { return timeoutState->stage != TimeoutTaskState::RUNNING; });
+      timerStarted= false;
     }
-#endif
   }
 
   /**
@@ -226,14 +251,12 @@ namespace mariadb
   void MariaDbStatement::executeEpilogue()
   {
     stopTimeoutTask();
-    isTimedout= false;
     setExecutingFlag(false);
   }
 
   void MariaDbStatement::executeBatchEpilogue(){
     setExecutingFlag(false);
     stopTimeoutTask();
-    isTimedout= false;
     clearBatch();
   }
 
@@ -1472,6 +1495,10 @@ namespace mariadb
 
   void MariaDbStatement::setExecutingFlag(bool _set) {
     executing= _set;
+    // Timeout flag is reset only when new execution starts - exception epilogues run after the timer is stopped, and need it
+    if (_set) {
+      isTimedout= false;
+    }
   }
 
   void MariaDbStatement::markClosed()
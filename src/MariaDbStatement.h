@@ -21,7 +21,10 @@
 #ifndef _MARIADBSTATEMENT_H_
 #define _MARIADBSTATEMENT_H_
 
+#include <atomic>
+#include <condition_variable>
 #include <map>
+#include <memory>
 #include <mutex>
 
 //#include "MariaDbConnection.h"
@@ -30,6 +33,7 @@
 #include "Statement.hpp"
 #include "Consts.h"
 #include "Charset.h"
+#include "pool/TimerWheel.h"
 
 namespace sql
 {
@@ -67,16 +71,22 @@ protected:
   sql::Longs largeBatchRes;
 
 private:
-#ifdef MAYBE_IN_NEXTVERSION
-  ScheduledExecutorService timeoutScheduler;
-#endif
   bool warningsCleared= true;
   bool mustCloseOnCompletion= false;
   std::vector<SQLString> batchQueries;
-#ifdef MAYBE_IN_NEXTVERSION
-  Future<?>timerTaskFuture;
-#endif
-  bool isTimedout= false;
+  /* State of the timeout task handed over to the executor. Shared with the task, that outlives the statement, if it
+   * has been canceled before it started */
+  struct TimeoutTaskState
+  {
+    enum Stage { IDLE, QUEUED, RUNNING } stage= IDLE;
+    std::mutex lock;
+    std::condition_variable done;
+  };
+  TimerWheel::Timer timeoutTimer;
+  std::shared_ptr<TimeoutTaskState> timeoutState;
+  bool timerStarted= false;
+  bool timerForBatch= false;
+  std::atomic<bool> isTimedout{false};
   uint32_t maxFieldSize= 0;
 
 public:
@@ -91,6 +101,8 @@ protected:
   void executeQueryPrologue(bool isBatch);
 private:
   void stopTimeoutTask();
+  void timeoutTask();
+  void killTimedOutQuery();
   MariaDBExceptionThrower handleFailoverAndTimeout(SQLException& sqle);
 public://protected:
   void executeEpilogue();
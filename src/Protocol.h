@@ -89,6 +89,7 @@ public:
   virtual const SQLString& getUsername() const=0;
   virtual bool ping()=0;
   virtual bool isValid(int32_t timeout)=0;
+  virtual bool isSocketClosed()=0;
   virtual void executeQuery(const SQLString& sql)=0;
   virtual void executeQuery(bool mustExecuteOnMaster, Results* results, const SQLString& sql)= 0;
   virtual void executeQuery(bool mustExecuteOnMaster, Results* results, const SQLString& sql, const Charset* charset)= 0;
@@ -161,6 +162,8 @@ public:
   virtual bool isEofDeprecated()=0;
   virtual int32_t getAutoIncrementIncrement()=0;
   virtual bool sessionStateAware()=0;
+  virtual bool isSessionStateChanged()=0;
+  virtual void setSessionStateChanged(bool changed)=0;
   virtual SQLString getTraces()=0;
   virtual bool isInterrupted()=0;
   virtual void stopIfInterrupted()=0;
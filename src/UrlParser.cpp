@@ -119,7 +119,8 @@ namespace mariadb
       }
       urlParser.haMode= parseHaMode(url, separator);
 
-      if (urlParser.haMode != HaMode::NONE && urlParser.haMode != HaMode::SEQUENTIAL)
+      if (urlParser.haMode != HaMode::NONE && urlParser.haMode != HaMode::SEQUENTIAL && urlParser.haMode != HaMode::LOADBALANCE &&
+        urlParser.haMode != HaMode::REPLICATION)
       {
         throw SQLFeatureNotImplementedException(SQLString("Support of the HA mode") + HaModeStrMap[urlParser.haMode] + "is not yet implemented");
       }
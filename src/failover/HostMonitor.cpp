@@ -0,0 +1,149 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include "HostMonitor.h"
+#include "HostStateTable.h"
+#include "protocol/MasterProtocol.h"
+#include "UrlParser.h"
+#include "pool/GlobalStateInfo.h"
+#include "util/LogQueryTool.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  namespace
+  {
+    struct Monitors
+    {
+      std::mutex lock;
+      std::map<SQLString, std::weak_ptr<HostMonitor>> monitors;
+    };
+
+    /* Never destructed - connections may be closed by other threads when statics are destroyed */
+    Monitors& getMonitors()
+    {
+      static Monitors* instance= new Monitors();
+      return *instance;
+    }
+  }
+
+  HostMonitor::HostMonitor(Shared::UrlParser& urlParser, const std::vector<HostAddress>& hosts, int32_t interval) :
+    state(new State())
+  {
+    state->urlParser= urlParser;
+    for (auto& host : hosts) {
+      state->probes.emplace_back(new Probe(state.get(), host));
+    }
+    for (auto& probe : state->probes) {
+      TimerWheel::getInstance().schedule(probe->timer, TimerWheel::Clock::duration::zero(), std::chrono::milliseconds(interval));
+    }
+  }
+
+  /* Checks, that are queued or running, finish with the state they hold. Connection is closed by the last of them */
+  HostMonitor::~HostMonitor()
+  {
+    state->stop= true;
+    for (auto& probe : state->probes) {
+      TimerWheel::getInstance().cancel(probe->timer);
+    }
+  }
+
+  /**
+   * Task of the probe's timer. Hands the check over to the background executor, unless the previous check of the host
+   * is still queued or running, e.g. blocked in connect. Timers are cancelled before the monitor releases the state,
+   * thus the state is alive here.
+   */
+  void HostMonitor::scheduleProbe(State& state, Probe& hostProbe)
+  {
+    if (hostProbe.running.exchange(true)) {
+      return;
+    }
+    std::shared_ptr<State> monitorState(state.shared_from_this());
+    Probe* running= &hostProbe;
+
+    TimerWheel::getBackgroundExecutor("MariaDb-host-monitor", 4).execute([monitorState, running]() {
+      if (!monitorState->stop.load()) {
+        probe(monitorState->urlParser, running->host, running->protocol);
+      }
+      running->running.store(false);
+    });
+  }
+
+  /**
+   * Returns the monitor of the given hosts, creating it if there is none.
+   *
+   * @param urlParser connection parameters. Used for monitor connections
+   * @param hosts hosts to monitor
+   * @return monitor, that runs while any reference to it is held
+   */
+  std::shared_ptr<HostMonitor> HostMonitor::getMonitor(Shared::UrlParser& urlParser, const std::vector<HostAddress>& hosts)
+  {
+    Monitors& registry= getMonitors();
+    SQLString key(urlParser->getUsername());
+    key.append("@").append(HostAddress::toString(hosts));
+
+    std::lock_guard<std::mutex> localScopeLock(registry.lock);
+    std::weak_ptr<HostMonitor>& monitorRef= registry.monitors[key];
+    std::shared_ptr<HostMonitor> monitor(monitorRef.lock());
+
+    if (!monitor) {
+      monitor.reset(new HostMonitor(urlParser, hosts, urlParser->getOptions()->hostMonitorInterval));
+      monitorRef= monitor;
+    }
+    return monitor;
+  }
+
+
+  /**
+   * Checks one host. Outcome of the connect attempt is recorded by the connect itself, ping outcome is recorded here.
+   */
+  void HostMonitor::probe(Shared::UrlParser& urlParser, const HostAddress& host, std::unique_ptr<MasterProtocol>& protocol)
+  {
+    if (!protocol || protocol->isClosed()) {
+      protocol.reset(new MasterProtocol(urlParser, new GlobalStateInfo()));
+      protocol->setHostAddress(host);
+      try {
+        protocol->connect();
+      }
+      catch (SQLException&) {
+        protocol.reset();
+      }
+      return;
+    }
+
+    bool alive= false;
+    try {
+      alive= protocol->ping();
+    }
+    catch (SQLException&) {
+    }
+
+    if (alive) {
+      HostStateTable::recordAlive(host);
+    }
+    else {
+      HostStateTable::recordFailure(host);
+      protocol.reset();
+    }
+  }
+}
+}
@@ -0,0 +1,88 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#ifndef _HOSTMONITOR_H_
+#define _HOSTMONITOR_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Consts.h"
+#include "HostAddress.h"
+#include "pool/TimerWheel.h"
+
+namespace sql
+{
+namespace mariadb
+{
+class MasterProtocol;
+
+/**
+ * Background health check of the hosts of a multi-host configuration. One monitor is shared by all connections with
+ * the same user and host list, and lives as long as any of them. Each host is checked every hostMonitorInterval
+ * milliseconds with COM_PING over a dedicated connection, that is re-established when lost. Results go to the
+ * HostStateTable, so connect paths skip dead hosts, and take recovered ones back, without waiting for connectTimeout.
+ * Checks are timed by the timer wheel, and run in a background executor, one check per host at a time.
+ */
+class HostMonitor
+{
+  struct State;
+
+  struct Probe
+  {
+    HostAddress host;
+    /* Used by one check at a time, guarded by the running flag */
+    std::unique_ptr<MasterProtocol> protocol;
+    /* Set while the check is queued or running */
+    std::atomic<bool> running{false};
+    TimerWheel::Timer timer;
+
+    Probe(State* state, const HostAddress& _host) : host(_host), timer([state, this]() { scheduleProbe(*state, *this); }) {}
+  };
+
+  /* Shared with queued and running checks, that may outlive the monitor while blocked in connect */
+  struct State : public std::enable_shared_from_this<State>
+  {
+    std::atomic<bool> stop{false};
+    Shared::UrlParser urlParser;
+    std::vector<std::unique_ptr<Probe>> probes;
+  };
+
+  std::shared_ptr<State> state;
+
+  HostMonitor(const HostMonitor&)= delete;
+  void operator=(const HostMonitor&)= delete;
+
+  static void scheduleProbe(State& state, Probe& probe);
+  static void probe(Shared::UrlParser& urlParser, const HostAddress& host, std::unique_ptr<MasterProtocol>& protocol);
+
+public:
+  HostMonitor(Shared::UrlParser& urlParser, const std::vector<HostAddress>& hosts, int32_t interval);
+  ~HostMonitor();
+
+  static std::shared_ptr<HostMonitor> getMonitor(Shared::UrlParser& urlParser, const std::vector<HostAddress>& hosts);
+};
+}
+}
+#endif
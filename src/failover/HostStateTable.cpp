@@ -0,0 +1,232 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+#include "HostStateTable.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  namespace
+  {
+    /* Exponential moving average with 1/4 weight of the new sample */
+    void addSample(std::atomic<int64_t>& average, int64_t sample)
+    {
+      int64_t current= average.load(), updated;
+
+      do {
+        updated= current == 0 ? sample : current + (sample - current) / 4;
+      } while (!average.compare_exchange_weak(current, updated));
+    }
+  }
+
+  std::atomic<const HostStateTable::Entries*> HostStateTable::entries{nullptr};
+  std::vector<std::unique_ptr<const HostStateTable::Entries>> HostStateTable::snapshots;
+  std::vector<std::unique_ptr<HostStateTable::Entry>> HostStateTable::allEntries;
+  std::mutex HostStateTable::writersLock;
+
+  SQLString HostStateTable::getKey(const HostAddress& host)
+  {
+    SQLString key(host.host);
+    key.append(":").append(std::to_string(host.port));
+    return key;
+  }
+
+
+  HostStateTable::Entry* HostStateTable::find(const HostAddress& host)
+  {
+    const Entries* current= entries.load(std::memory_order_acquire);
+    if (current == nullptr) {
+      return nullptr;
+    }
+    auto it= current->find(getKey(host));
+
+    return it != current->end() ? it->second : nullptr;
+  }
+
+  /**
+   * Returns entry of the host, adding it to the table if needed. Adding copies the table and publishes the copy, so
+   * readers never see the table being modified.
+   */
+  HostStateTable::Entry* HostStateTable::getOrCreate(const HostAddress& host)
+  {
+    Entry* entry= find(host);
+    if (entry != nullptr) {
+      return entry;
+    }
+
+    std::lock_guard<std::mutex> localScopeLock(writersLock);
+    const Entries* current= entries.load(std::memory_order_acquire);
+    SQLString key(getKey(host));
+
+    if (current != nullptr) {
+      auto it= current->find(key);
+      if (it != current->end()) {
+        return it->second;
+      }
+    }
+    Entries* updated= current != nullptr ? new Entries(*current) : new Entries();
+    entry= new Entry();
+    allEntries.emplace_back(entry);
+    updated->emplace(key, entry);
+    snapshots.emplace_back(updated);
+    entries.store(updated, std::memory_order_release);
+
+    return entry;
+  }
+
+  /**
+   * Records successful connection to the host.
+   *
+   * @param host server address
+   * @param connectTime time it took to connect
+   */
+  void HostStateTable::recordSuccess(const HostAddress& host, std::chrono::nanoseconds connectTime)
+  {
+    Entry* entry= getOrCreate(host);
+
+    addSample(entry->latency, connectTime.count());
+    entry->consecutiveFailures= 0;
+  }
+
+  /**
+   * Records round trip time of a ping to the host, e.g. of the health check or of the connection validation. Unlike
+   * connect time, it reflects the current load of the server. Hosts that have never been connected are not recorded.
+   *
+   * @param host server address
+   * @param roundTrip time it took the server to answer
+   */
+  void HostStateTable::recordQueryLatency(const HostAddress& host, std::chrono::nanoseconds roundTrip)
+  {
+    Entry* entry= find(host);
+
+    if (entry) {
+      addSample(entry->queryLatency, roundTrip.count());
+    }
+  }
+
+
+  void HostStateTable::recordFailure(const HostAddress& host)
+  {
+    Entry* entry= getOrCreate(host);
+
+    entry->lastFailure= std::chrono::steady_clock::now().time_since_epoch().count();
+    ++entry->consecutiveFailures;
+  }
+
+  /**
+   * Records that the host has answered the health check. Unlike recordSuccess, that does not affect the latency.
+   *
+   * @param host server address
+   */
+  void HostStateTable::recordAlive(const HostAddress& host)
+  {
+    Entry* entry= find(host);
+
+    if (entry) {
+      entry->consecutiveFailures= 0;
+    }
+  }
+
+  /**
+   * Checks if the last connection attempt to the host has failed less than blacklistTimeout seconds ago.
+   *
+   * @param host server address
+   * @param blacklistTimeout time in seconds the host is considered unavailable after a failure
+   * @return true if the host is known to be unavailable
+   */
+  bool HostStateTable::isBlacklisted(const HostAddress& host, int32_t blacklistTimeout)
+  {
+    Entry* entry= find(host);
+
+    if (!entry || entry->consecutiveFailures == 0) {
+      return false;
+    }
+    std::chrono::steady_clock::time_point lastFailure{std::chrono::steady_clock::duration(entry->lastFailure.load())};
+
+    return std::chrono::steady_clock::now() - lastFailure < std::chrono::seconds(blacklistTimeout);
+  }
+
+
+  void HostStateTable::connectionOpened(const HostAddress& host)
+  {
+    ++getOrCreate(host)->openConnections;
+  }
+
+
+  void HostStateTable::connectionClosed(const HostAddress& host)
+  {
+    Entry* entry= find(host);
+
+    if (entry) {
+      uint32_t open= entry->openConnections.load();
+      while (open > 0 && !entry->openConnections.compare_exchange_weak(open, open - 1)) {
+      }
+    }
+  }
+
+  /**
+   * Load score of the host for load balancing - the less the better. That is ping latency, or connect latency if no
+   * ping has been timed yet, weighted by the number of connections to the host, currently open in the process. Hosts
+   * with unknown latency get the score of 1ms latency.
+   *
+   * @param host server address
+   * @return load score
+   */
+  int64_t HostStateTable::getLoadScore(const HostAddress& host)
+  {
+    static const int64_t baseLatency= 1000000;
+    Entry* entry= find(host);
+
+    if (!entry) {
+      return baseLatency;
+    }
+    int64_t latency= entry->queryLatency.load();
+
+    if (latency == 0) {
+      latency= entry->latency.load();
+    }
+    return (latency > 0 ? latency : baseLatency) * (entry->openConnections.load() + 1);
+  }
+
+
+  bool HostStateTable::get(const HostAddress& host, HostState& state)
+  {
+    Entry* entry= find(host);
+
+    if (!entry) {
+      return false;
+    }
+    state.latency= entry->latency.load();
+    state.queryLatency= entry->queryLatency.load();
+    state.consecutiveFailures= entry->consecutiveFailures.load();
+    state.openConnections= entry->openConnections.load();
+    state.lastFailure= std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(entry->lastFailure.load()));
+    return true;
+  }
+
+
+  void HostStateTable::clear()
+  {
+    std::lock_guard<std::mutex> localScopeLock(writersLock);
+    entries.store(nullptr, std::memory_order_release);
+  }
+}
+}
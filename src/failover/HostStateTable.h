@@ -0,0 +1,96 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+#ifndef _HOSTSTATETABLE_H_
+#define _HOSTSTATETABLE_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Consts.h"
+#include "HostAddress.h"
+
+namespace sql
+{
+namespace mariadb
+{
+/**
+ * Process-wide record of recent connect and ping latency, failures and number of open connections of the servers. It
+ * is used to order connection attempts in multi-host modes - known unavailable hosts are tried last, and in LOADBALANCE
+ * mode hosts with lower latency and fewer connections are preferred.
+ * Lookups do not take locks - the table is an immutable snapshot of per-host entries with atomic fields, read with an
+ * acquire load of a raw pointer. Snapshot is replaced only when a new host is added. Replaced snapshots and entries are
+ * never freed, since readers may still hold them - their number is bounded by the number of distinct hosts.
+ */
+class HostStateTable
+{
+public:
+  struct HostState
+  {
+    /* Smoothed connect time in nanoseconds, 0 if not known */
+    int64_t latency= 0;
+    /* Smoothed ping round trip time in nanoseconds, 0 if not known */
+    int64_t queryLatency= 0;
+    uint32_t consecutiveFailures= 0;
+    uint32_t openConnections= 0;
+    std::chrono::steady_clock::time_point lastFailure;
+  };
+
+private:
+  struct Entry
+  {
+    std::atomic<int64_t> latency{0};
+    std::atomic<int64_t> queryLatency{0};
+    std::atomic<uint32_t> consecutiveFailures{0};
+    std::atomic<uint32_t> openConnections{0};
+    /* steady_clock time of the last failure in nanoseconds */
+    std::atomic<int64_t> lastFailure{0};
+  };
+  typedef std::map<SQLString, Entry*> Entries;
+
+  static std::atomic<const Entries*> entries;
+  /* Owners of all published snapshots and entries. Guarded by writersLock */
+  static std::vector<std::unique_ptr<const Entries>> snapshots;
+  static std::vector<std::unique_ptr<Entry>> allEntries;
+  static std::mutex writersLock;
+
+  static SQLString getKey(const HostAddress& host);
+  static Entry* find(const HostAddress& host);
+  static Entry* getOrCreate(const HostAddress& host);
+
+public:
+  static void recordSuccess(const HostAddress& host, std::chrono::nanoseconds connectTime);
+  static void recordQueryLatency(const HostAddress& host, std::chrono::nanoseconds roundTrip);
+  static void recordFailure(const HostAddress& host);
+  static void recordAlive(const HostAddress& host);
+  static bool isBlacklisted(const HostAddress& host, int32_t blacklistTimeout);
+  static void connectionOpened(const HostAddress& host);
+  static void connectionClosed(const HostAddress& host);
+  static int64_t getLoadScore(const HostAddress& host);
+  static bool get(const HostAddress& host, HostState& state);
+  static void clear();
+};
+}
+}
+#endif
@@ -0,0 +1,957 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include "MastersReplicasProtocol.h"
+
+#include "protocol/MasterProtocol.h"
+#include "failover/HostStateTable.h"
+#include "Results.h"
+#include "util/LogQueryTool.h"
+#include "ExceptionFactory.h"
+#include "logger/LoggerFactory.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  static Logger* logger= LoggerFactory::getLogger(typeid(MastersReplicasProtocol));
+  static const std::chrono::seconds REPLICA_LAG_CHECK_INTERVAL(1);
+  static const std::chrono::seconds REPLICA_KEEP_ALIVE_INTERVAL(30);
+
+  /**
+   * The replica is used by the background ping only while it is idle, i.e. not the current connection. Connection's
+   * thread holds the lock while it touches the replica, and while it makes it current or not.
+   */
+  struct MastersReplicasProtocol::ReplicaKeepAlive
+  {
+    std::mutex lock;
+    std::shared_ptr<MasterProtocol> replica;
+    bool idle= true;
+    /* Set while a ping is queued or running */
+    std::atomic<bool> running{false};
+
+    ReplicaKeepAlive(std::shared_ptr<MasterProtocol>& _replica) : replica(_replica) {}
+
+    /* Task of the keep-alive timer. Ping may block on the network, thus it runs in the background executor */
+    static void schedule(std::shared_ptr<ReplicaKeepAlive>& keepAlive)
+    {
+      if (keepAlive->running.exchange(true)) {
+        return;
+      }
+      std::shared_ptr<ReplicaKeepAlive> state(keepAlive);
+
+      TimerWheel::getBackgroundExecutor("MariaDb-replica-keep-alive", 2).execute([state]() {
+        {
+          std::lock_guard<std::mutex> keepAliveLock(state->lock);
+          if (state->idle && !state->replica->isClosed()) {
+            bool alive= false;
+            try {
+              alive= state->replica->ping();
+            }
+            catch (SQLException&) {
+            }
+            if (!alive) {
+              logger->info("Replica " + state->replica->getHostAddress().toString() + " does not respond to ping");
+              HostStateTable::recordFailure(state->replica->getHostAddress());
+              state->replica->close();
+            }
+          }
+        }
+        state->running.store(false);
+      });
+    }
+  };
+
+
+  MastersReplicasProtocol::MastersReplicasProtocol(Shared::UrlParser& _urlParser, GlobalStateInfo* globalInfo) :
+    urlParser(_urlParser),
+    master(new MasterProtocol(_urlParser, globalInfo)),
+    // Global state info belongs to the master's server, and is owned by the master protocol
+    replica(new MasterProtocol(_urlParser, nullptr)),
+    current(master.get()),
+    readOnly(false),
+    lagCheckedAt(std::chrono::steady_clock::now()),
+    replicaRetryAt(lagCheckedAt),
+    keepAlive(new ReplicaKeepAlive(replica)),
+    keepAliveTimer([this]() { ReplicaKeepAlive::schedule(keepAlive); })
+  {
+    for (auto& host : urlParser->getHostAddresses()) {
+      if (host.type.compare(ParameterConstant::TYPE_SLAVE) == 0) {
+        replicaHosts.push_back(host);
+      }
+      else {
+        masterHosts.push_back(host);
+      }
+    }
+    if (!replicaHosts.empty()) {
+      TimerWheel::getInstance().schedule(keepAliveTimer, REPLICA_KEEP_ALIVE_INTERVAL, REPLICA_KEEP_ALIVE_INTERVAL);
+    }
+  }
+
+
+  /* Ping that is queued or running holds the replica, and the replica's connection is closed by whoever is the last */
+  MastersReplicasProtocol::~MastersReplicasProtocol()
+  {
+    TimerWheel::getInstance().cancel(keepAliveTimer);
+  }
+
+  /**
+   * Connect to one of the masters. Connection to a replica is only established when it is needed for the first time.
+   */
+  void MastersReplicasProtocol::connectWithoutProxy()
+  {
+    if (masterHosts.empty()) {
+      ExceptionFactory::INSTANCE.create("No master host is defined in the connection url " + urlParser->getInitialUrl(),
+        "08000").Throw();
+    }
+    master->connectToHosts(masterHosts, false);
+    current= master.get();
+  }
+
+  /**
+   * Checks the open replica with a ping before it is switched to. Replica that does not respond is closed and
+   * blacklisted. Must be called with the keep-alive lock held.
+   *
+   * @return true if the replica is open and responds
+   */
+  bool MastersReplicasProtocol::replicaAlive()
+  {
+    if (replica->isClosed()) {
+      return false;
+    }
+    if (current == replica.get()) {
+      return true;
+    }
+    try {
+      if (replica->ping()) {
+        return true;
+      }
+    }
+    catch (SQLException&) {
+    }
+    logger->info("Replica " + replica->getHostAddress().toString() + " does not respond to ping and is not used");
+    HostStateTable::recordFailure(replica->getHostAddress());
+    replica->close();
+    return false;
+  }
+
+  /**
+   * Connect to the best available replica, skipping ones lagging behind master more than maxReplicationLag.
+   *
+   * @return true if a replica has been connected
+   */
+  bool MastersReplicasProtocol::connectReplica()
+  {
+    std::vector<HostAddress> candidates(replicaHosts);
+
+    while (!candidates.empty()) {
+      try {
+        replica->connectToHosts(candidates, true);
+      }
+      catch (SQLException& e) {
+        logger->warn("Could not connect to any replica, queries stay on master: " + e.getMessage());
+        return false;
+      }
+
+      if (replicaLagAcceptable()) {
+        return true;
+      }
+      const HostAddress& lagging= replica->getHostAddress();
+      logger->info("Replica " + lagging.toString() + " is lagging behind master too much and is not used");
+      HostStateTable::recordFailure(lagging);
+
+      for (auto it= candidates.begin(); it != candidates.end(); ++it) {
+        if (it->host.compare(lagging.host) == 0 && it->port == lagging.port) {
+          candidates.erase(it);
+          break;
+        }
+      }
+      replica->close();
+    }
+    return false;
+  }
+
+  /**
+   * Checks replica's lag against maxReplicationLag option. Replica with stopped replication(NULL lag) is not accepted.
+   * If the lag can't be read(e.g. no privilege), the replica is accepted.
+   */
+  bool MastersReplicasProtocol::replicaLagAcceptable()
+  {
+    int32_t maxLag= urlParser->getOptions()->maxReplicationLag;
+
+    if (maxLag <= 0) {
+      return true;
+    }
+    try {
+      Results results;
+      replica->executeQuery(false, &results, "SHOW SLAVE STATUS");
+      results.commandEnd();
+      ResultSet* rs= results.getResultSet();
+
+      // Server that is not a replica at all has nothing to lag behind
+      if (rs == nullptr || !rs->next()) {
+        return true;
+      }
+      int64_t lag= rs->getLong("Seconds_Behind_Master");
+      return !rs->wasNull() && lag <= maxLag;
+    }
+    catch (SQLException& e) {
+      logger->debug("Could not read replication lag: " + e.getMessage());
+    }
+    return true;
+  }
+
+  /**
+   * Moves session state from current connection to the target, and makes the target current. Must be called with
+   * the keep-alive lock held.
+   */
+  void MastersReplicasProtocol::switchTo(Protocol* to)
+  {
+    if (current->inTransaction()) {
+      throw SQLException("Read-only mode cannot be changed while a transaction is in progress", "25001");
+    }
+    current->skip();
+    to->resetStateAfterFailover(current->getMaxRows(), current->getTransactionIsolationLevel(), current->getDatabase(),
+      current->getAutocommit());
+    current= to;
+    keepAlive->idle= current != replica.get();
+  }
+
+  /**
+   * Server side prepared statements only exist on the master.
+   */
+  Protocol* MastersReplicasProtocol::forStatement(ServerPrepareResult* serverPrepareResult)
+  {
+    return serverPrepareResult != nullptr ? master.get() : current;
+  }
+
+
+  void MastersReplicasProtocol::setReadonly(bool _readOnly)
+  {
+    Protocol* target= master.get();
+    std::lock_guard<std::mutex> keepAliveLock(keepAlive->lock);
+
+    if (_readOnly && !replicaHosts.empty() && (replicaAlive() || connectReplica())) {
+      target= replica.get();
+    }
+    else if (_readOnly && !replicaHosts.empty()) {
+      replicaRetryAt= std::chrono::steady_clock::now() + std::chrono::seconds(urlParser->getOptions()->loadBalanceBlacklistTimeout);
+    }
+    if (target != current) {
+      switchTo(target);
+    }
+    readOnly= _readOnly;
+    master->setReadonly(_readOnly);
+  }
+
+  /**
+   * Called before each query in read-only mode. Moves reads to the master if the replica has died, has been
+   * blacklisted(e.g. by the host monitor) or lags too much(checked at most once per second). While reads are on the
+   * master, connecting a replica is retried after loadBalanceBlacklistTimeout. Nothing is switched inside a transaction.
+   */
+  void MastersReplicasProtocol::checkReplica()
+  {
+    if (!readOnly || replicaHosts.empty() || current->inTransaction()) {
+      return;
+    }
+    auto now= std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> keepAliveLock(keepAlive->lock);
+
+    if (current == master.get()) {
+      if (now >= replicaRetryAt) {
+        if (connectReplica()) {
+          lagCheckedAt= now;
+          switchTo(replica.get());
+        }
+        else {
+          replicaRetryAt= now + std::chrono::seconds(urlParser->getOptions()->loadBalanceBlacklistTimeout);
+        }
+      }
+      return;
+    }
+
+    bool usable= !replica->isClosed() &&
+      !HostStateTable::isBlacklisted(replica->getHostAddress(), urlParser->getOptions()->loadBalanceBlacklistTimeout);
+
+    if (usable && now - lagCheckedAt >= REPLICA_LAG_CHECK_INTERVAL) {
+      lagCheckedAt= now;
+      if (!replicaLagAcceptable()) {
+        HostStateTable::recordFailure(replica->getHostAddress());
+        usable= false;
+      }
+    }
+    if (!usable) {
+      logger->info("Replica " + replica->getHostAddress().toString() + " is not usable anymore, read-only queries go to master");
+      switchTo(master.get());
+      if (!replica->isClosed()) {
+        replica->close();
+      }
+      replicaRetryAt= now + std::chrono::seconds(urlParser->getOptions()->loadBalanceBlacklistTimeout);
+    }
+  }
+
+
+  FailoverProxy* MastersReplicasProtocol::getProxy()
+  {
+    return nullptr;
+  }
+
+
+  ServerPrepareResult* MastersReplicasProtocol::prepare(const SQLString& sql, bool executeOnMaster)
+  {
+    return master->prepare(sql, executeOnMaster);
+  }
+
+
+  bool MastersReplicasProtocol::getAutocommit()
+  {
+    return current->getAutocommit();
+  }
+
+
+  bool MastersReplicasProtocol::noBackslashEscapes()
+  {
+    return current->noBackslashEscapes();
+  }
+
+
+  void MastersReplicasProtocol::connect()
+  {
+    current->connect();
+  }
+
+
+  const UrlParser& MastersReplicasProtocol::getUrlParser() const
+  {
+    return master->getUrlParser();
+  }
+
+
+  bool MastersReplicasProtocol::inTransaction()
+  {
+    return current->inTransaction();
+  }
+
+
+  void MastersReplicasProtocol::setProxy(FailoverProxy* proxy)
+  {
+    current->setProxy(proxy);
+  }
+
+
+  const Shared::Options& MastersReplicasProtocol::getOptions() const
+  {
+    return master->getOptions();
+  }
+
+
+  bool MastersReplicasProtocol::hasMoreResults()
+  {
+    return current->hasMoreResults();
+  }
+
+
+  void MastersReplicasProtocol::close()
+  {
+    {
+      std::lock_guard<std::mutex> keepAliveLock(keepAlive->lock);
+      if (!replica->isClosed()) {
+        replica->close();
+      }
+    }
+    master->close();
+  }
+
+
+  void MastersReplicasProtocol::abort()
+  {
+    {
+      std::lock_guard<std::mutex> keepAliveLock(keepAlive->lock);
+      if (!replica->isClosed()) {
+        replica->abort();
+      }
+    }
+    master->abort();
+  }
+
+
+  void MastersReplicasProtocol::reset()
+  {
+    {
+      std::lock_guard<std::mutex> keepAliveLock(keepAlive->lock);
+      if (!replica->isClosed()) {
+        replica->reset();
+      }
+    }
+    master->reset();
+  }
+
+
+  void MastersReplicasProtocol::closeExplicit()
+  {
+    {
+      std::lock_guard<std::mutex> keepAliveLock(keepAlive->lock);
+      if (!replica->isClosed()) {
+        replica->closeExplicit();
+      }
+    }
+    master->closeExplicit();
+  }
+
+
+  void MastersReplicasProtocol::markClosed(bool closed)
+  {
+    {
+      std::lock_guard<std::mutex> keepAliveLock(keepAlive->lock);
+      if (!replica->isClosed()) {
+        replica->markClosed(closed);
+      }
+    }
+    master->markClosed(closed);
+  }
+
+
+  bool MastersReplicasProtocol::isClosed()
+  {
+    return master->isClosed();
+  }
+
+
+  void MastersReplicasProtocol::resetDatabase()
+  {
+    current->resetDatabase();
+  }
+
+
+  SQLString MastersReplicasProtocol::getCatalog()
+  {
+    return current->getCatalog();
+  }
+
+
+  void MastersReplicasProtocol::setCatalog(const SQLString& database)
+  {
+    current->setCatalog(database);
+  }
+
+
+  const SQLString& MastersReplicasProtocol::getServerVersion() const
+  {
+    return current->getServerVersion();
+  }
+
+
+  bool MastersReplicasProtocol::isConnected()
+  {
+    return current->isConnected();
+  }
+
+
+  bool MastersReplicasProtocol::getReadonly() const
+  {
+    return readOnly;
+  }
+
+
+  bool MastersReplicasProtocol::isMasterConnection()
+  {
+    return current->isMasterConnection();
+  }
+
+
+  bool MastersReplicasProtocol::mustBeMasterConnection()
+  {
+    return current->mustBeMasterConnection();
+  }
+
+
+  const HostAddress& MastersReplicasProtocol::getHostAddress() const
+  {
+    return current->getHostAddress();
+  }
+
+
+  void MastersReplicasProtocol::setHostAddress(const HostAddress& hostAddress)
+  {
+    current->setHostAddress(hostAddress);
+  }
+
+
+  const SQLString& MastersReplicasProtocol::getHost() const
+  {
+    return current->getHost();
+  }
+
+
+  int32_t MastersReplicasProtocol::getPort() const
+  {
+    return current->getPort();
+  }
+
+
+  void MastersReplicasProtocol::rollback()
+  {
+    current->rollback();
+  }
+
+
+  const SQLString& MastersReplicasProtocol::getDatabase() const
+  {
+    return current->getDatabase();
+  }
+
+
+  const SQLString& MastersReplicasProtocol::getUsername() const
+  {
+    return current->getUsername();
+  }
+
+
+  bool MastersReplicasProtocol::ping()
+  {
+    return current->ping();
+  }
+
+
+  bool MastersReplicasProtocol::isValid(int32_t timeout)
+  {
+    return current->isValid(timeout);
+  }
+
+
+  bool MastersReplicasProtocol::isSocketClosed()
+  {
+    return current->isSocketClosed();
+  }
+
+
+  void MastersReplicasProtocol::executeQuery(const SQLString& sql)
+  {
+    current->executeQuery(sql);
+  }
+
+
+  void MastersReplicasProtocol::executeQuery(bool mustExecuteOnMaster, Results* results, const SQLString& sql)
+  {
+    current->executeQuery(mustExecuteOnMaster, results, sql);
+  }
+
+
+  void MastersReplicasProtocol::executeQuery(bool mustExecuteOnMaster, Results* results, const SQLString& sql, const Charset* charset)
+  {
+    current->executeQuery(mustExecuteOnMaster, results, sql, charset);
+  }
+
+
+  void MastersReplicasProtocol::executeQuery(bool mustExecuteOnMaster, Results* results, ClientPrepareResult* clientPrepareResult, std::vector<Unique::ParameterHolder>& parameters)
+  {
+    current->executeQuery(mustExecuteOnMaster, results, clientPrepareResult, parameters);
+  }
+
+
+  void MastersReplicasProtocol::executeQuery(bool mustExecuteOnMaster, Results* results, ClientPrepareResult* clientPrepareResult, std::vector<Unique::ParameterHolder>& parameters, int32_t timeout)
+  {
+    current->executeQuery(mustExecuteOnMaster, results, clientPrepareResult, parameters, timeout);
+  }
+
+
+  bool MastersReplicasProtocol::executeBatchClient(bool mustExecuteOnMaster, Results* results, ClientPrepareResult* prepareResult, std::vector<std::vector<Unique::ParameterHolder>>& parametersList, bool hasLongData)
+  {
+    return current->executeBatchClient(mustExecuteOnMaster, results, prepareResult, parametersList, hasLongData);
+  }
+
+
+  void MastersReplicasProtocol::executeBatchStmt(bool mustExecuteOnMaster, Results* results, const std::vector<SQLString>& queries)
+  {
+    current->executeBatchStmt(mustExecuteOnMaster, results, queries);
+  }
+
+
+  void MastersReplicasProtocol::executePreparedQuery(bool mustExecuteOnMaster, ServerPrepareResult* serverPrepareResult, Results* results, std::vector<Unique::ParameterHolder>& parameters)
+  {
+    master->executePreparedQuery(mustExecuteOnMaster, serverPrepareResult, results, parameters);
+  }
+
+
+  bool MastersReplicasProtocol::executeBatchServer(bool mustExecuteOnMaster, ServerPrepareResult* serverPrepareResult, Results* results, const SQLString& sql, std::vector<std::vector<Unique::ParameterHolder>>& parameterList, bool hasLongData)
+  {
+    return master->executeBatchServer(mustExecuteOnMaster, serverPrepareResult, results, sql, parameterList, hasLongData);
+  }
+
+
+  void MastersReplicasProtocol::moveToNextResult(Results* results, ServerPrepareResult* spr)
+  {
+    forStatement(spr)->moveToNextResult(results, spr);
+  }
+
+
+  void MastersReplicasProtocol::getResult(Results* results, ServerPrepareResult *pr, bool readAllResults)
+  {
+    forStatement(pr)->getResult(results, pr, readAllResults);
+  }
+
+
+  void MastersReplicasProtocol::cancelCurrentQuery()
+  {
+    current->cancelCurrentQuery();
+  }
+
+
+  void MastersReplicasProtocol::interrupt()
+  {
+    current->interrupt();
+  }
+
+
+  void MastersReplicasProtocol::skip()
+  {
+    current->skip();
+  }
+
+
+  bool MastersReplicasProtocol::checkIfMaster()
+  {
+    return current->checkIfMaster();
+  }
+
+
+  bool MastersReplicasProtocol::hasWarnings()
+  {
+    return current->hasWarnings();
+  }
+
+
+  int64_t MastersReplicasProtocol::getMaxRows()
+  {
+    return current->getMaxRows();
+  }
+
+
+  void MastersReplicasProtocol::setMaxRows(int64_t max)
+  {
+    current->setMaxRows(max);
+  }
+
+
+  uint32_t MastersReplicasProtocol::getMajorServerVersion()
+  {
+    return current->getMajorServerVersion();
+  }
+
+
+  uint32_t MastersReplicasProtocol::getMinorServerVersion()
+  {
+    return current->getMinorServerVersion();
+  }
+
+
+  uint32_t MastersReplicasProtocol::getPatchServerVersion()
+  {
+    return current->getPatchServerVersion();
+  }
+
+
+  bool MastersReplicasProtocol::versionGreaterOrEqual(uint32_t major, uint32_t minor, uint32_t patch) const
+  {
+    return current->versionGreaterOrEqual(major, minor, patch);
+  }
+
+
+  int32_t MastersReplicasProtocol::getTimeout()
+  {
+    return current->getTimeout();
+  }
+
+
+  void MastersReplicasProtocol::setTimeout(int32_t timeout)
+  {
+    {
+      std::lock_guard<std::mutex> keepAliveLock(keepAlive->lock);
+      if (!replica->isClosed()) {
+        replica->setTimeout(timeout);
+      }
+    }
+    master->setTimeout(timeout);
+  }
+
+
+  bool MastersReplicasProtocol::getPinGlobalTxToPhysicalConnection() const
+  {
+    return current->getPinGlobalTxToPhysicalConnection();
+  }
+
+
+  int64_t MastersReplicasProtocol::getServerThreadId()
+  {
+    return current->getServerThreadId();
+  }
+
+
+  void MastersReplicasProtocol::setTransactionIsolation(int32_t level)
+  {
+    current->setTransactionIsolation(level);
+  }
+
+
+  int32_t MastersReplicasProtocol::getTransactionIsolationLevel()
+  {
+    return current->getTransactionIsolationLevel();
+  }
+
+
+  bool MastersReplicasProtocol::isExplicitClosed()
+  {
+    return master->isExplicitClosed();
+  }
+
+
+  bool MastersReplicasProtocol::shouldReconnectWithoutProxy()
+  {
+    return current->shouldReconnectWithoutProxy();
+  }
+
+
+  void MastersReplicasProtocol::setHostFailedWithoutProxy()
+  {
+    current->setHostFailedWithoutProxy();
+  }
+
+
+  void MastersReplicasProtocol::releasePrepareStatement(ServerPrepareResult* serverPrepareResult)
+  {
+    master->releasePrepareStatement(serverPrepareResult);
+  }
+
+
+  bool MastersReplicasProtocol::forceReleasePrepareStatement(capi::MYSQL_STMT* statementId)
+  {
+    return master->forceReleasePrepareStatement(statementId);
+  }
+
+
+  void MastersReplicasProtocol::forceReleaseWaitingPrepareStatement()
+  {
+    master->forceReleaseWaitingPrepareStatement();
+  }
+
+
+  Cache* MastersReplicasProtocol::prepareStatementCache()
+  {
+    return master->prepareStatementCache();
+  }
+
+
+  TimeZone* MastersReplicasProtocol::getTimeZone()
+  {
+    return current->getTimeZone();
+  }
+
+
+  void MastersReplicasProtocol::prolog(int64_t maxRows, bool hasProxy, MariaDbConnection* connection, MariaDbStatement* statement)
+  {
+    checkReplica();
+    current->prolog(maxRows, hasProxy, connection, statement);
+  }
+
+
+  void MastersReplicasProtocol::prologProxy(ServerPrepareResult* serverPrepareResult, int64_t maxRows, bool hasProxy, MariaDbConnection* connection, MariaDbStatement* statement)
+  {
+    master->prologProxy(serverPrepareResult, maxRows, hasProxy, connection, statement);
+  }
+
+
+  Results* MastersReplicasProtocol::getActiveStreamingResult()
+  {
+    return current->getActiveStreamingResult();
+  }
+
+
+  void MastersReplicasProtocol::setActiveStreamingResult(Results* mariaSelectResultSet)
+  {
+    current->setActiveStreamingResult(mariaSelectResultSet);
+  }
+
+
+  std::mutex *const MastersReplicasProtocol::getLock()
+  {
+    return master->getLock();
+  }
+
+
+  void MastersReplicasProtocol::setServerStatus(uint32_t serverStatus)
+  {
+    current->setServerStatus(serverStatus);
+  }
+
+
+  uint32_t MastersReplicasProtocol::getServerStatus()
+  {
+    return current->getServerStatus();
+  }
+
+
+  void MastersReplicasProtocol::removeHasMoreResults()
+  {
+    current->removeHasMoreResults();
+  }
+
+
+  void MastersReplicasProtocol::setHasWarnings(bool hasWarnings)
+  {
+    current->setHasWarnings(hasWarnings);
+  }
+
+
+  ServerPrepareResult* MastersReplicasProtocol::addPrepareInCache(const SQLString& key, ServerPrepareResult* serverPrepareResult)
+  {
+    return master->addPrepareInCache(key, serverPrepareResult);
+  }
+
+
+  void MastersReplicasProtocol::readEofPacket()
+  {
+    current->readEofPacket();
+  }
+
+
+  void MastersReplicasProtocol::skipEofPacket()
+  {
+    current->skipEofPacket();
+  }
+
+
+  void MastersReplicasProtocol::changeSocketTcpNoDelay(bool setTcpNoDelay)
+  {
+    current->changeSocketTcpNoDelay(setTcpNoDelay);
+  }
+
+
+  void MastersReplicasProtocol::changeSocketSoTimeout(int32_t setSoTimeout)
+  {
+    current->changeSocketSoTimeout(setSoTimeout);
+  }
+
+
+  void MastersReplicasProtocol::removeActiveStreamingResult()
+  {
+    current->removeActiveStreamingResult();
+  }
+
+
+  void MastersReplicasProtocol::resetStateAfterFailover(int64_t maxRows, int32_t transactionIsolationLevel, const SQLString& database, bool autocommit)
+  {
+    current->resetStateAfterFailover(maxRows, transactionIsolationLevel, database, autocommit);
+  }
+
+
+  bool MastersReplicasProtocol::isServerMariaDb()
+  {
+    return current->isServerMariaDb();
+  }
+
+
+  void MastersReplicasProtocol::setActiveFutureTask(FutureTask* activeFutureTask)
+  {
+    current->setActiveFutureTask(activeFutureTask);
+  }
+
+
+  MariaDBExceptionThrower MastersReplicasProtocol::handleIoException(std::runtime_error& initialException, bool throwRightAway)
+  {
+    return current->handleIoException(initialException, throwRightAway);
+  }
+
+
+  bool MastersReplicasProtocol::isEofDeprecated()
+  {
+    return current->isEofDeprecated();
+  }
+
+
+  int32_t MastersReplicasProtocol::getAutoIncrementIncrement()
+  {
+    return current->getAutoIncrementIncrement();
+  }
+
+
+  bool MastersReplicasProtocol::sessionStateAware()
+  {
+    return current->sessionStateAware();
+  }
+
+
+  bool MastersReplicasProtocol::isSessionStateChanged()
+  {
+    if (master->isSessionStateChanged()) {
+      return true;
+    }
+    std::lock_guard<std::mutex> keepAliveLock(keepAlive->lock);
+    return !replica->isClosed() && replica->isSessionStateChanged();
+  }
+
+
+  void MastersReplicasProtocol::setSessionStateChanged(bool changed)
+  {
+    master->setSessionStateChanged(changed);
+    std::lock_guard<std::mutex> keepAliveLock(keepAlive->lock);
+    if (!replica->isClosed()) {
+      replica->setSessionStateChanged(changed);
+    }
+  }
+
+
+  SQLString MastersReplicasProtocol::getTraces()
+  {
+    return current->getTraces();
+  }
+
+
+  bool MastersReplicasProtocol::isInterrupted()
+  {
+    return current->isInterrupted();
+  }
+
+
+  void MastersReplicasProtocol::stopIfInterrupted()
+  {
+    current->stopIfInterrupted();
+  }
+
+
+  void MastersReplicasProtocol::reconnect()
+  {
+    current->reconnect();
+  }
+
+
+  void MastersReplicasProtocol::skipAllResults()
+  {
+    current->skipAllResults();
+  }
+
+
+  void MastersReplicasProtocol::skipAllResults(ServerPrepareResult* spr)
+  {
+    forStatement(spr)->skipAllResults(spr);
+  }
+
+}
+}
@@ -0,0 +1,184 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#ifndef _MASTERSREPLICASPROTOCOL_H_
+#define _MASTERSREPLICASPROTOCOL_H_
+
+#include <vector>
+#include <chrono>
+#include <memory>
+
+#include "Protocol.h"
+#include "Consts.h"
+#include "HostAddress.h"
+#include "pool/TimerWheel.h"
+
+namespace sql
+{
+namespace mariadb
+{
+class MasterProtocol;
+class GlobalStateInfo;
+
+/**
+ * Protocol for the REPLICATION HA mode. Holds a connection to one of the masters, and lazily opens one to
+ * a replica when the connection is switched to read-only mode. Queries are sent to the replica while the
+ * connection is read-only, and to the master otherwise. Server side prepared statements always run on the master.
+ * Before each query in read-only mode the replica is re-checked: a closed, blacklisted or lagging replica is dropped
+ * and reads go to the master until a replica can be connected again. Replica that is kept open while the connection is
+ * not read-only is pinged periodically in the background, and once more before it is switched to.
+ */
+class MastersReplicasProtocol : public Protocol
+{
+  Shared::UrlParser urlParser;
+  std::shared_ptr<MasterProtocol> master;
+  std::shared_ptr<MasterProtocol> replica;
+  Protocol* current;
+  std::vector<HostAddress> masterHosts;
+  std::vector<HostAddress> replicaHosts;
+  bool readOnly;
+  std::chrono::steady_clock::time_point lagCheckedAt;
+  std::chrono::steady_clock::time_point replicaRetryAt;
+  /* Shared with the background pings of the idle replica */
+  struct ReplicaKeepAlive;
+  std::shared_ptr<ReplicaKeepAlive> keepAlive;
+  TimerWheel::Timer keepAliveTimer;
+
+  MastersReplicasProtocol()= delete;
+
+  bool replicaAlive();
+  bool connectReplica();
+  bool replicaLagAcceptable();
+  void switchTo(Protocol* to);
+  void checkReplica();
+  Protocol* forStatement(ServerPrepareResult* serverPrepareResult);
+
+public:
+  MastersReplicasProtocol(Shared::UrlParser& urlParser, GlobalStateInfo* globalInfo);
+  ~MastersReplicasProtocol();
+
+  ServerPrepareResult* prepare(const SQLString& sql, bool executeOnMaster);
+  bool getAutocommit();
+  bool noBackslashEscapes();
+  void connect();
+  const UrlParser& getUrlParser() const;
+  bool inTransaction();
+  FailoverProxy* getProxy();
+  void setProxy(FailoverProxy* proxy);
+  const Shared::Options& getOptions() const;
+  bool hasMoreResults();
+  void close();
+  void abort();
+  void reset();
+  void closeExplicit();
+  void markClosed(bool closed);
+  bool isClosed();
+  void resetDatabase();
+  SQLString getCatalog();
+  void setCatalog(const SQLString& database);
+  const SQLString& getServerVersion() const;
+  bool isConnected();
+  bool getReadonly() const;
+  void setReadonly(bool readOnly);
+  bool isMasterConnection();
+  bool mustBeMasterConnection();
+  const HostAddress& getHostAddress() const;
+  void setHostAddress(const HostAddress& hostAddress);
+  const SQLString& getHost() const;
+  int32_t getPort() const;
+  void rollback();
+  const SQLString& getDatabase() const;
+  const SQLString& getUsername() const;
+  bool ping();
+  bool isValid(int32_t timeout);
+  bool isSocketClosed();
+  void executeQuery(const SQLString& sql);
+  void executeQuery(bool mustExecuteOnMaster, Results* results, const SQLString& sql);
+  void executeQuery(bool mustExecuteOnMaster, Results* results, const SQLString& sql, const Charset* charset);
+  void executeQuery(bool mustExecuteOnMaster, Results* results, ClientPrepareResult* clientPrepareResult, std::vector<Unique::ParameterHolder>& parameters);
+  void executeQuery(bool mustExecuteOnMaster, Results* results, ClientPrepareResult* clientPrepareResult, std::vector<Unique::ParameterHolder>& parameters, int32_t timeout);
+  bool executeBatchClient(bool mustExecuteOnMaster, Results* results, ClientPrepareResult* prepareResult, std::vector<std::vector<Unique::ParameterHolder>>& parametersList, bool hasLongData);
+  void executeBatchStmt(bool mustExecuteOnMaster, Results* results, const std::vector<SQLString>& queries);
+  void executePreparedQuery(bool mustExecuteOnMaster, ServerPrepareResult* serverPrepareResult, Results* results, std::vector<Unique::ParameterHolder>& parameters);
+  bool executeBatchServer(bool mustExecuteOnMaster, ServerPrepareResult* serverPrepareResult, Results* results, const SQLString& sql, std::vector<std::vector<Unique::ParameterHolder>>& parameterList, bool hasLongData);
+  void moveToNextResult(Results* results, ServerPrepareResult* spr= nullptr);
+  void getResult(Results* results, ServerPrepareResult *pr=nullptr, bool readAllResults= false);
+  void cancelCurrentQuery();
+  void interrupt();
+  void skip();
+  bool checkIfMaster();
+  bool hasWarnings();
+  int64_t getMaxRows();
+  void setMaxRows(int64_t max);
+  uint32_t getMajorServerVersion();
+  uint32_t getMinorServerVersion();
+  uint32_t getPatchServerVersion();
+  bool versionGreaterOrEqual(uint32_t major, uint32_t minor, uint32_t patch) const;
+  int32_t getTimeout();
+  void setTimeout(int32_t timeout);
+  bool getPinGlobalTxToPhysicalConnection() const;
+  int64_t getServerThreadId();
+  void setTransactionIsolation(int32_t level);
+  int32_t getTransactionIsolationLevel();
+  bool isExplicitClosed();
+  void connectWithoutProxy();
+  bool shouldReconnectWithoutProxy();
+  void setHostFailedWithoutProxy();
+  void releasePrepareStatement(ServerPrepareResult* serverPrepareResult);
+  bool forceReleasePrepareStatement(capi::MYSQL_STMT* statementId);
+  void forceReleaseWaitingPrepareStatement();
+  Cache* prepareStatementCache();
+  TimeZone* getTimeZone();
+  void prolog(int64_t maxRows, bool hasProxy, MariaDbConnection* connection, MariaDbStatement* statement);
+  void prologProxy(ServerPrepareResult* serverPrepareResult, int64_t maxRows, bool hasProxy, MariaDbConnection* connection, MariaDbStatement* statement);
+  Results* getActiveStreamingResult();
+  void setActiveStreamingResult(Results* mariaSelectResultSet);
+  std::mutex *const getLock();
+  void setServerStatus(uint32_t serverStatus);
+  uint32_t getServerStatus();
+  void removeHasMoreResults();
+  void setHasWarnings(bool hasWarnings);
+  ServerPrepareResult* addPrepareInCache(const SQLString& key, ServerPrepareResult* serverPrepareResult);
+  void readEofPacket();
+  void skipEofPacket();
+  void changeSocketTcpNoDelay(bool setTcpNoDelay);
+  void changeSocketSoTimeout(int32_t setSoTimeout);
+  void removeActiveStreamingResult();
+  void resetStateAfterFailover(int64_t maxRows, int32_t transactionIsolationLevel, const SQLString& database, bool autocommit);
+  bool isServerMariaDb();
+  void setActiveFutureTask(FutureTask* activeFutureTask);
+  MariaDBExceptionThrower handleIoException(std::runtime_error& initialException, bool throwRightAway= true);
+  bool isEofDeprecated();
+  int32_t getAutoIncrementIncrement();
+  bool sessionStateAware();
+  bool isSessionStateChanged();
+  void setSessionStateChanged(bool changed);
+  SQLString getTraces();
+  bool isInterrupted();
+  void stopIfInterrupted();
+  void reconnect();
+  void skipAllResults() override;
+  void skipAllResults(ServerPrepareResult* spr) override;
+};
+
+}
+}
+#endif
@@ -263,6 +263,12 @@ namespace mariadb
 	}
 
 
+  bool ProtocolLoggingProxy::isSocketClosed()
+  {
+    return protocol->isSocketClosed();
+  }
+
+
   void ProtocolLoggingProxy::executeQuery(const SQLString& sql)
 	{
 		/* Add here logging if needed */
@@ -700,6 +706,18 @@ namespace mariadb
 	}
 
 
+  bool ProtocolLoggingProxy::isSessionStateChanged()
+  {
+    return protocol->isSessionStateChanged();
+  }
+
+
+  void ProtocolLoggingProxy::setSessionStateChanged(bool changed)
+  {
+    protocol->setSessionStateChanged(changed);
+  }
+
+
   SQLString ProtocolLoggingProxy::getTraces()
 	{
 		/* Add here logging if needed */
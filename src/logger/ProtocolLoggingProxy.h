@@ -84,6 +84,7 @@ public:
   const SQLString& getUsername() const;
   bool ping();
   bool isValid(int32_t timeout);
+  bool isSocketClosed();
   void executeQuery(const SQLString& sql);
   void executeQuery(bool mustExecuteOnMaster, Results* results, const SQLString& sql);
   void executeQuery(bool mustExecuteOnMaster, Results* results, const SQLString& sql, const Charset* charset);
@@ -150,6 +151,8 @@ public:
   bool isEofDeprecated();
   int32_t getAutoIncrementIncrement();
   bool sessionStateAware();
+  bool isSessionStateChanged();
+  void setSessionStateChanged(bool changed);
   SQLString getTraces();
   bool isInterrupted();
   void stopIfInterrupted();
@@ -153,6 +153,14 @@ namespace sql
         " This permits better performance when the database is not in the same location.",
         false,
         false}},
+      {
+        "compressionAlgorithm", {"compressionAlgorithm",
+        "1.1.6",
+        "Compression algorithm to use for the exchange with the database. Setting it turns the compression on. "
+        "Only \"zlib\" is supported by the protocol implementation. Packets shorter than 50 bytes are always sent "
+        "uncompressed",
+        false,
+        ""}},
       {
         "allowMultiQueries", {"allowMultiQueries",
         "0.9.1",
@@ -278,6 +286,38 @@ namespace sql
         false,
         (int32_t)50,
         int32_t(0)}},
+      {
+        "parallelConnectDelay", {"parallelConnectDelay",
+        "1.1.6",
+        "With multiple hosts, time in milliseconds to wait for the connection attempt before starting the attempt to "
+        "the next host in parallel. The first host to complete the handshake is used, thus slower higher priority host "
+        "may lose to the next one. 0 means hosts are tried one by one.",
+        false,
+        (int32_t)0,
+        int32_t(0)}},
+      {
+        "maxReplicationLag", {"maxReplicationLag",
+        "1.1.6",
+        "In REPLICATION mode, maximum replication lag in seconds for a replica to be used for read-only queries. "
+        "0 means the lag is not checked.",
+        false,
+        (int32_t)0,
+        int32_t(0)}},
+      {
+        "hostMonitorInterval", {"hostMonitorInterval",
+        "1.1.6",
+        "With multiple hosts, interval in milliseconds of the background health check of the hosts. One monitor is "
+        "shared by all connections to the same hosts. 0 disables the monitor.",
+        false,
+        (int32_t)0,
+        int32_t(0)}},
+      {
+        "warmStandby", {"warmStandby",
+        "1.1.6",
+        "With multiple hosts, keep spare connection to the next host. Connection::reconnect() switches to it, "
+        "and restores the session state with one query.",
+        false,
+        false}},
       {
         "cachePrepStmts", {"cachePrepStmts",
         "1.1.3",
@@ -526,7 +566,7 @@ namespace sql
         "*Not compatible with aurora*\n"
         "During connection, different queries are executed. When option is active those queries are send using"
         " pipeline (all queries are send, then only all results are reads), permitting faster connection "
-        "creation",
+        "creation. Otherwise they are sent as one multi-statement query",
         false,
         false}},
       {
@@ -587,7 +627,7 @@ namespace sql
         "When connections are removed due to not being used for "
         "longer than than \"maxIdleTime\", connections are closed and removed from the pool. \"minPoolSize\" "
         "indicates the number of physical connections the pool should keep available at all times. Should be less"
-        " or equal to maxPoolSize.",
+        " or equal to maxPoolSize. At pool creation these connections are opened in parallel.",
         false,
         (int32_t)0,
         int32_t(0)}},
@@ -611,14 +651,77 @@ namespace sql
         false,
         (int32_t)1000,
         int32_t(0)}},
+      {
+        "poolThreadAffinity", {"poolThreadAffinity",
+        "1.1.6",
+        "The connection, that a thread gives back to the pool, is kept aside for that thread, and is returned to it on "
+        "its next request, if it is still idle. Other threads take such connections only if the pool has no other "
+        "idle connection.",
+        false,
+        false}},
+      {
+        "poolLocalValidation", {"poolLocalValidation",
+        "1.1.6",
+        "Before giving out an idle connection, that needs validation by poolValidMinDelay, the pool checks its socket "
+        "locally, discards it if it has been idle longer than server's wait_timeout, and accepts it without COM_PING "
+        "if it has been idle less than half of wait_timeout. COM_PING is sent only in other cases. With false, "
+        "COM_PING is always sent.",
+        false,
+        true}},
+      {
+        "poolAdaptiveSizing", {"poolAdaptiveSizing",
+        "1.1.6",
+        "The pool tracks peak concurrent demand for connections over the last poolSizingWindow seconds, and keeps "
+        "that many connections, between minPoolSize and maxPoolSize. It grows ahead of a rising demand, and closes "
+        "connections, one per second, only after demand has stayed lower for the whole window.",
+        false,
+        false}},
+      {
+        "poolSizingWindow", {"poolSizingWindow",
+        "1.1.6",
+        "With poolAdaptiveSizing, length in seconds of the window of observed demand.",
+        false,
+        (int32_t)60,
+        int32_t(1)}},
+      {
+        "poolMaxConnectRate", {"poolMaxConnectRate",
+        "1.1.6",
+        "Maximum number of new connections per second, that the pool opens. 0 means no limit.",
+        false,
+        (int32_t)0,
+        int32_t(0)}},
+      {
+        "poolFailFast", {"poolFailFast",
+        "1.1.6",
+        "When the pool has maxPoolSize connections, and none is idle, request for a connection fails right away, if "
+        "the expected wait exceeds connectTimeout. The wait is estimated from the number of requests ahead in the "
+        "queue, and the average time connections are held by the application.",
+        false,
+        false}},
+      {
+        "poolWarmupStatements", {"poolWarmupStatements",
+        "1.1.6",
+        "Semicolon separated list of SQL statements, that the pool prepares on each new connection before making it "
+        "available. With useServerPrepStmts and cachePrepStmts that fills the prepared statements cache of the "
+        "connection.",
+        false}},
       {
         "staticGlobal", {"staticGlobal",
         "0.9.1",
         "Indicates the values of the global variables "
         "max_allowed_packet, wait_timeout, autocommit, auto_increment_increment, time_zone, system_time_zone and"
-        " tx_isolation) won't be changed, permitting the pool to create new connections faster.",
+        " tx_isolation) won't be changed, permitting the pool to create new connections faster. Values are read once "
+        "per server and user, and cached process-wide.",
         false,
         false}},
+      {
+        "staticGlobalTtl", {"staticGlobalTtl",
+        "1.1.6",
+        "With staticGlobal, time in seconds the cached server global variables values are considered valid. "
+        "Cached values are also discarded, if the server version or capabilities change. 0 means values never expire.",
+        false,
+        (int32_t)3600,
+        int32_t(0)}},
       {
         "useResetConnection", {"useResetConnection",
         "1.1.1",
@@ -629,6 +732,17 @@ namespace sql
         "application make extensive use of variables. Must not be used with the useServerPrepStmts option",
         false,
         true }},
+      {
+        "skipUnchangedReset", {"skipUnchangedReset",
+        "1.1.6",
+        "With useResetConnection, the pool does not reset the connection, if there is no open transaction, and the "
+        "server has not reported session state changes. Autocommit and current database changed with Connection "
+        "methods are restored without reset, but changed with SQL statements they require reset. Table locks and "
+        "named locks(GET_LOCK) are not reported by the server, and have to be released by the application, thus the "
+        "option is off by default. Prepared statements cached before reset are prepared again on the first prepare "
+        "after it.",
+        false,
+        false}},
       {
         "allowMasterDownConnection", {"allowMasterDownConnection",
         "0.9.1",
@@ -643,7 +757,8 @@ namespace sql
         "Usually, Connection.isValid just send an empty packet to "
         "server, and server send a small response to ensure connectivity. When this option is set, connector will"
         " ensure Galera server state \"wsrep_local_state\" correspond to allowed values (separated by comma). "
-        "Example \"4,5\", recommended is \"4\". see galera state to know more.",
+        "Example \"4,5\", recommended is \"4\". see galera state to know more. In LOADBALANCE mode, hosts in other "
+        "states are not used for new connections.",
         false}},
       {
         "useAffectedRows", {"useAffectedRows",
@@ -1115,6 +1230,14 @@ namespace sql
         throw SQLFeatureNotImplementedException("Callable statement caches are not supported yet");
       }
 
+      if (!options->compressionAlgorithm.empty()) {
+        if (options->compressionAlgorithm.compare("zlib") != 0) {
+          throw SQLFeatureNotSupportedException("Compression algorithm '" + options->compressionAlgorithm
+            + "' is not supported, only 'zlib' is available");
+        }
+        options->useCompression= true;
+      }
+
       if (options->defaultFetchSize < 0) {
         options->defaultFetchSize= 0;
       }
@@ -1124,10 +1247,6 @@ namespace sql
         options->useTls= true;
       }
 
-      if (options->usePipelineAuth) {
-        throw SQLFeatureNotSupportedException("Pipe identification is not supported yet");
-      }
-
       if (options->useCharacterEncoding.compare("utf8") == 0) {
         options->useCharacterEncoding = "utf8mb4";
       }
@@ -76,6 +76,7 @@ namespace mariadb
     OPTIONS_FIELD(allowMultiQueries),
     OPTIONS_FIELD(rewriteBatchedStatements),
     OPTIONS_FIELD(useCompression),
+    OPTIONS_FIELD(compressionAlgorithm),
     OPTIONS_FIELD(interactiveClient),
     OPTIONS_FIELD(passwordCharacterEncoding),
     OPTIONS_FIELD(useCharacterEncoding),
@@ -127,6 +128,10 @@ namespace mariadb
     OPTIONS_FIELD(retriesAllDown),
     OPTIONS_FIELD(validConnectionTimeout),
     OPTIONS_FIELD(loadBalanceBlacklistTimeout),
+    OPTIONS_FIELD(parallelConnectDelay),
+    OPTIONS_FIELD(maxReplicationLag),
+    OPTIONS_FIELD(hostMonitorInterval),
+    OPTIONS_FIELD(warmStandby),
     OPTIONS_FIELD(failoverLoopRetries),
     OPTIONS_FIELD(allowMasterDownConnection),
     OPTIONS_FIELD(galeraAllowedState),
@@ -136,8 +141,17 @@ namespace mariadb
     OPTIONS_FIELD(minPoolSize),
     OPTIONS_FIELD(maxIdleTime),
     OPTIONS_FIELD(staticGlobal),
+    OPTIONS_FIELD(staticGlobalTtl),
     OPTIONS_FIELD(poolValidMinDelay),
+    OPTIONS_FIELD(poolThreadAffinity),
+    OPTIONS_FIELD(poolLocalValidation),
+    OPTIONS_FIELD(poolAdaptiveSizing),
+    OPTIONS_FIELD(poolSizingWindow),
+    OPTIONS_FIELD(poolMaxConnectRate),
+    OPTIONS_FIELD(poolFailFast),
+    OPTIONS_FIELD(poolWarmupStatements),
     OPTIONS_FIELD(useResetConnection),
+    OPTIONS_FIELD(skipUnchangedReset),
     OPTIONS_FIELD(useReadAheadInput),
     OPTIONS_FIELD(serverRsaPublicKeyFile),
     OPTIONS_FIELD(tlsPeerFP)
@@ -278,6 +292,9 @@ namespace mariadb
     if (useCompression != opt->useCompression) {
       return false;
     }
+    if (compressionAlgorithm.compare(opt->compressionAlgorithm) != 0) {
+      return false;
+    }
     if (interactiveClient != opt->interactiveClient) {
       return false;
     }
@@ -374,6 +391,18 @@ namespace mariadb
     if (loadBalanceBlacklistTimeout != opt->loadBalanceBlacklistTimeout) {
       return false;
     }
+    if (parallelConnectDelay != opt->parallelConnectDelay) {
+      return false;
+    }
+    if (maxReplicationLag != opt->maxReplicationLag) {
+      return false;
+    }
+    if (hostMonitorInterval != opt->hostMonitorInterval) {
+      return false;
+    }
+    if (warmStandby != opt->warmStandby) {
+      return false;
+    }
     if (failoverLoopRetries != opt->failoverLoopRetries) {
       return false;
     }
@@ -383,9 +412,15 @@ namespace mariadb
     if (staticGlobal != opt->staticGlobal) {
       return false;
     }
+    if (staticGlobalTtl != opt->staticGlobalTtl) {
+      return false;
+    }
     if (useResetConnection != opt->useResetConnection) {
       return false;
     }
+    if (skipUnchangedReset != opt->skipUnchangedReset) {
+      return false;
+    }
     if (useReadAheadInput != opt->useReadAheadInput) {
       return false;
     }
@@ -398,6 +433,24 @@ namespace mariadb
     if (poolValidMinDelay != opt->poolValidMinDelay) {
       return false;
     }
+    if (poolThreadAffinity != opt->poolThreadAffinity) {
+      return false;
+    }
+    if (poolLocalValidation != opt->poolLocalValidation) {
+      return false;
+    }
+    if (poolAdaptiveSizing != opt->poolAdaptiveSizing) {
+      return false;
+    }
+    if (poolSizingWindow != opt->poolSizingWindow) {
+      return false;
+    }
+    if (poolMaxConnectRate != opt->poolMaxConnectRate) {
+      return false;
+    }
+    if (poolFailFast != opt->poolFailFast) {
+      return false;
+    }
     if (user.compare(opt->user) != 0) {
       return false;
     }
@@ -512,6 +565,9 @@ namespace mariadb
     if (!(poolName.compare(opt->poolName) == 0)) {
       return false;
     }
+    if (!(poolWarmupStatements.compare(opt->poolWarmupStatements) == 0)) {
+      return false;
+    }
     if (!(galeraAllowedState.compare(opt->galeraAllowedState) == 0)) {
       return false;
     }
@@ -559,6 +615,7 @@ namespace mariadb
     result= 31 *result + (allowMultiQueries ? 1 : 0);
     result= 31 *result + (rewriteBatchedStatements ? 1 : 0);
     result= 31 *result + (useCompression ? 1 : 0);
+    result= 31 *result + (!compressionAlgorithm.empty() ? compressionAlgorithm.hashCode() : 0);
     result= 31 *result + (interactiveClient ? 1 : 0);
     result= 31 *result + (!passwordCharacterEncoding.empty() ? passwordCharacterEncoding.hashCode() : 0);
     result= 31 *result + (!useCharacterEncoding.empty() ? useCharacterEncoding.hashCode() : 0);
@@ -604,17 +661,30 @@ namespace mariadb
     result= 31 *result +retriesAllDown;
     result= 31 *result +validConnectionTimeout;
     result= 31 *result +loadBalanceBlacklistTimeout;
+    result= 31 *result + parallelConnectDelay;
+    result= 31 *result + maxReplicationLag;
+    result= 31 *result + hostMonitorInterval;
+    result= 31 *result + (warmStandby ? 1 : 0);
     result= 31 *result +failoverLoopRetries;
     result= 31 *result + (pool ? 1 : 0);
     result= 31 *result + (useResetConnection ? 1 : 0);
+    result= 31 *result + (skipUnchangedReset ? 1 : 0);
     result= 31 *result + (useReadAheadInput ? 1 : 0);
     result= 31 *result + (staticGlobal ? 1 : 0);
+    result= 31 *result + staticGlobalTtl;
     result= 31 *result + (!poolName.empty() ? poolName.hashCode() : 0);
+    result= 31 *result + (!poolWarmupStatements.empty() ? poolWarmupStatements.hashCode() : 0);
     result= 31 *result + (!galeraAllowedState.empty() ? galeraAllowedState.hashCode() : 0);
     result= 31 *result + maxPoolSize;
     result= 31 *result + (minPoolSize > 0 ? hash(minPoolSize) : 0);
     result= 31 *result + maxIdleTime;
     result= 31 *result + poolValidMinDelay;
+    result= 31 *result + (poolThreadAffinity ? 1 : 0);
+    result= 31 *result + (poolLocalValidation ? 1 : 0);
+    result= 31 *result + (poolAdaptiveSizing ? 1 : 0);
+    result= 31 *result + poolSizingWindow;
+    result= 31 *result + poolMaxConnectRate;
+    result= 31 *result + (poolFailFast ? 1 : 0);
     result= 31 *result + (autocommit ? 1 : 0);
     result= 31 *result + (!credentialType.empty() ? credentialType.hashCode() : 0);
 
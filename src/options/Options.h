@@ -71,6 +71,7 @@ struct Options
   bool      allowMultiQueries;
   bool      rewriteBatchedStatements;
   bool      useCompression;
+  SQLString compressionAlgorithm;
   bool      interactiveClient;
   SQLString passwordCharacterEncoding;
   SQLString useCharacterEncoding;
@@ -124,6 +125,10 @@ struct Options
   int32_t   retriesAllDown= 120;
   int32_t   validConnectionTimeout;
   int32_t   loadBalanceBlacklistTimeout= 50;
+  int32_t   parallelConnectDelay= 0;
+  int32_t   maxReplicationLag= 0;
+  int32_t   hostMonitorInterval= 0;
+  bool      warmStandby= false;
   int32_t   failoverLoopRetries= 120;
   bool      allowMasterDownConnection;
   SQLString galeraAllowedState;
@@ -133,8 +138,17 @@ struct Options
   int32_t   minPoolSize;
   int32_t   maxIdleTime= 600;
   bool      staticGlobal;
+  int32_t   staticGlobalTtl= 3600;
   int32_t   poolValidMinDelay= 1000;
+  bool      poolThreadAffinity= false;
+  bool      poolLocalValidation= true;
+  bool      poolAdaptiveSizing= false;
+  int32_t   poolSizingWindow= 60;
+  int32_t   poolMaxConnectRate= 0;
+  bool      poolFailFast= false;
+  SQLString poolWarmupStatements;
   bool      useResetConnection;
+  bool      skipUnchangedReset= false;
   bool      useReadAheadInput= true;
   SQLString serverRsaPublicKeyFile;
   SQLString tlsPeerFP;
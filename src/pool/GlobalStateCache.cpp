@@ -0,0 +1,119 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+#include "GlobalStateCache.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  std::map<SQLString, GlobalStateCache::Entry> GlobalStateCache::cache;
+  std::mutex GlobalStateCache::cacheLock;
+
+  /**
+   * Cache key for the server and connection session settings
+   *
+   * @param user connection user, since init_connect is not run for SUPER users, and values may differ per user
+   * @param host server host
+   * @param port server port
+   * @param sessionVariables sessionVariables option value, since it may change cached values
+   * @return key string
+   */
+  SQLString GlobalStateCache::getKey(const SQLString& user, const SQLString& host, int32_t port, const SQLString& sessionVariables)
+  {
+    SQLString key(user);
+    key.append("@").append(host).append(":").append(std::to_string(port));
+    if (!sessionVariables.empty()) {
+      key.append("/").append(sessionVariables);
+    }
+    return key;
+  }
+
+  /**
+   * Looks for valid cached server state. Expired or stale(server version or capabilities have changed) entry is removed.
+   *
+   * @param key cache key
+   * @param serverVersion version string server sent in the handshake
+   * @param serverCapabilities capabilities server sent in the handshake
+   * @param ttl maximum age of the entry in seconds, 0 means entry does not expire
+   * @param info [out] cached state
+   * @return true if valid entry has been found
+   */
+  bool GlobalStateCache::get(const SQLString& key, const SQLString& serverVersion, int64_t serverCapabilities, int32_t ttl,
+    GlobalStateInfo& info)
+  {
+    std::lock_guard<std::mutex> localScopeLock(cacheLock);
+    auto it= cache.find(key);
+
+    if (it == cache.end()) {
+      return false;
+    }
+    if (it->second.serverVersion.compare(serverVersion) != 0 || it->second.serverCapabilities != serverCapabilities
+      || (ttl > 0 && std::chrono::steady_clock::now() - it->second.created > std::chrono::seconds(ttl))) {
+      cache.erase(it);
+      return false;
+    }
+    info= it->second.info;
+    return true;
+  }
+
+  /**
+   * Looks for cached server state without validating it against the handshake data.
+   *
+   * @param key cache key
+   * @param info [out] cached state
+   * @return true if entry has been found
+   */
+  bool GlobalStateCache::get(const SQLString& key, GlobalStateInfo& info)
+  {
+    std::lock_guard<std::mutex> localScopeLock(cacheLock);
+    auto it= cache.find(key);
+
+    if (it == cache.end()) {
+      return false;
+    }
+    info= it->second.info;
+    return true;
+  }
+
+  void GlobalStateCache::put(const SQLString& key, const SQLString& serverVersion, int64_t serverCapabilities,
+    const GlobalStateInfo& info)
+  {
+    std::lock_guard<std::mutex> localScopeLock(cacheLock);
+    Entry& entry= cache[key];
+
+    entry.info= info;
+    entry.serverVersion= serverVersion;
+    entry.serverCapabilities= serverCapabilities;
+    entry.created= std::chrono::steady_clock::now();
+  }
+
+  void GlobalStateCache::invalidate(const SQLString& key)
+  {
+    std::lock_guard<std::mutex> localScopeLock(cacheLock);
+    cache.erase(key);
+  }
+
+  void GlobalStateCache::clear()
+  {
+    std::lock_guard<std::mutex> localScopeLock(cacheLock);
+    cache.clear();
+  }
+}
+}
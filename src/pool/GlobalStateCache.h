@@ -0,0 +1,63 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+#ifndef _GLOBALSTATECACHE_H_
+#define _GLOBALSTATECACHE_H_
+
+#include <chrono>
+#include <map>
+#include <mutex>
+
+#include "GlobalStateInfo.h"
+
+namespace sql
+{
+namespace mariadb
+{
+/**
+ * Process-wide cache of server global state, i.e. values normally read by each new connection after connect.
+ * Entries are keyed by user, host, port and session variables set by the connection. An entry is valid while the server
+ * version and capabilities reported in the handshake are the same, and it is not older than the given TTL.
+ */
+class GlobalStateCache
+{
+  struct Entry
+  {
+    GlobalStateInfo info;
+    SQLString       serverVersion;
+    int64_t         serverCapabilities;
+    std::chrono::steady_clock::time_point created;
+  };
+
+  static std::map<SQLString, Entry> cache;
+  static std::mutex cacheLock;
+
+public:
+  static SQLString getKey(const SQLString& user, const SQLString& host, int32_t port, const SQLString& sessionVariables);
+  static bool get(const SQLString& key, const SQLString& serverVersion, int64_t serverCapabilities, int32_t ttl,
+    GlobalStateInfo& info);
+  static bool get(const SQLString& key, GlobalStateInfo& info);
+  static void put(const SQLString& key, const SQLString& serverVersion, int64_t serverCapabilities,
+    const GlobalStateInfo& info);
+  static void invalidate(const SQLString& key);
+  static void clear();
+};
+}
+}
+#endif
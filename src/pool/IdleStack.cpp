@@ -0,0 +1,409 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <algorithm>
+#include <thread>
+
+#include "IdleStack.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  /**
+   * @param maxSize maximum number of connections in the pool. There is no point to have more shards or slots
+   * @param threadAffinity if threads should have own slots for the connection they have returned last
+   */
+  IdleStack::IdleStack(std::size_t maxSize, bool threadAffinity)
+    : slots(threadAffinity ? std::max<std::size_t>(1, maxSize) : 0)
+  {
+    std::size_t shardCount= std::max<std::size_t>(1, std::min<std::size_t>(std::thread::hardware_concurrency(), maxSize));
+
+    for (std::size_t i= 0; i < shardCount; ++i) {
+      shards.emplace_back(new Shard());
+    }
+    for (auto& slot : slots) {
+      slot.store(nullptr);
+    }
+  }
+
+  /* Threads are numbered in order of their first use of any pool, and spread over shards and slots round-robin */
+  std::size_t IdleStack::getThreadIndex()
+  {
+    static std::atomic<std::size_t> nextThreadIndex{0};
+    static thread_local std::size_t threadIndex= nextThreadIndex++;
+
+    return threadIndex;
+  }
+
+
+  std::size_t IdleStack::getHomeShard() const
+  {
+    return getThreadIndex() % shards.size();
+  }
+
+  /**
+   * Takes connection from the own slot, if there is one, then most recently pushed connection from the home shard,
+   * or, if it is empty, from the first non-empty shard after it. Slots of other threads are the last resort.
+   */
+  IdleStack::Item IdleStack::take()
+  {
+    if (closed.load(std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    std::size_t ownSlot= 0;
+
+    if (!slots.empty()) {
+      ownSlot= getThreadIndex() % slots.size();
+      Item item= slots[ownSlot].exchange(nullptr);
+      if (item != nullptr) {
+        --itemCount;
+        return item;
+      }
+    }
+    if (itemCount.load() == 0) {
+      return nullptr;
+    }
+    std::size_t home= getHomeShard();
+
+    for (std::size_t i= 0; i < shards.size(); ++i) {
+      Shard& shard= *shards[(home + i) % shards.size()];
+
+      if (shard.count.load(std::memory_order_relaxed) == 0) {
+        continue;
+      }
+      std::lock_guard<std::mutex> shardLock(shard.lock);
+      if (!shard.items.empty()) {
+        Item item= shard.items.back();
+        shard.items.pop_back();
+        --shard.count;
+        --itemCount;
+        return item;
+      }
+    }
+    return slots.empty() ? nullptr : stealFromSlots(ownSlot);
+  }
+
+
+  IdleStack::Item IdleStack::stealFromSlots(std::size_t ownSlot)
+  {
+    for (std::size_t i= 1; i <= slots.size(); ++i) {
+      std::atomic<Item>& slot= slots[(ownSlot + i) % slots.size()];
+
+      if (slot.load(std::memory_order_relaxed) != nullptr) {
+        Item item= slot.exchange(nullptr);
+        if (item != nullptr) {
+          --itemCount;
+          return item;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * Hands connection over to the first waiter, if there is one. Otherwise pushes connection to the own slot, if
+   * requested and the slot is free, or to the home shard.
+   * Nobody is waiting for connections parked in slots, thus if there are waiters, connection goes to the shard.
+   *
+   * @param toOwnSlot if the connection is returned by the thread that has been using it
+   * @return false if the stack has been closed, and connection has not been added
+   */
+  bool IdleStack::push(Item item, bool toOwnSlot)
+  {
+    if (closed.load()) {
+      return false;
+    }
+    if (waiters.load() > 0 && handTo(item)) {
+      return true;
+    }
+    if (toOwnSlot && !slots.empty() && waiters.load() == 0) {
+      std::atomic<Item>& slot= slots[getThreadIndex() % slots.size()];
+      Item expected= nullptr;
+
+      if (slot.compare_exchange_strong(expected, item)) {
+        ++itemCount;
+        // Waiter increments the counter before its last check, that includes slots. Thus either it finds the
+        // connection, or we see it here and move the connection where the waiter is woken up for
+        if (waiters.load() == 0) {
+          return true;
+        }
+        item= slot.exchange(nullptr);
+        if (item == nullptr) {
+          return true;
+        }
+        --itemCount;
+      }
+    }
+    pushToShard(item);
+    return true;
+  }
+
+  /* Pushes connection to the home shard, and hands it over to a waiter, if there is any */
+  void IdleStack::pushToShard(Item item)
+  {
+    Shard& shard= *shards[getHomeShard()];
+    {
+      std::lock_guard<std::mutex> shardLock(shard.lock);
+      // Counted before the item can be popped, so a concurrent pop never takes the count below zero
+      ++itemCount;
+      shard.items.push_back(item);
+      ++shard.count;
+    }
+
+    // Waiter increments the counter before its last check of the shards under waitLock, thus it can't miss this item
+    if (waiters.load() > 0) {
+      handOff();
+    }
+  }
+
+  /* Returns the oldest waiter of the highest priority class. Must be called with waitLock held */
+  IdleStack::Waiter* IdleStack::firstWaiter()
+  {
+    for (auto& queue : waitQueues) {
+      if (!queue.empty()) {
+        return queue.front();
+      }
+    }
+    return nullptr;
+  }
+
+  /* Dequeues the first waiter, and wakes it up with the connection. Must be called with waitLock held */
+  void IdleStack::wake(Waiter& waiter, Item item)
+  {
+    waitQueues[waiter.priority].pop_front();
+    waiter.item= item;
+    waiter.wakeUp.notify_one();
+  }
+
+  /* Gives the connection directly to the first waiter. Returns false if nobody is queued */
+  bool IdleStack::handTo(Item item)
+  {
+    std::lock_guard<std::mutex> localScopeLock(waitLock);
+    Waiter* waiter= firstWaiter();
+
+    if (waiter == nullptr) {
+      return false;
+    }
+    wake(*waiter, item);
+    return true;
+  }
+
+  /* Moves connections from shards to queued waiters, while there are both */
+  void IdleStack::handOff()
+  {
+    std::lock_guard<std::mutex> localScopeLock(waitLock);
+    Waiter* waiter;
+
+    while ((waiter= firstWaiter()) != nullptr) {
+      Item item= take();
+      if (item == nullptr) {
+        break;
+      }
+      wake(*waiter, item);
+    }
+  }
+
+
+  IdleStack::Item IdleStack::poll()
+  {
+    return take();
+  }
+
+  /**
+   * Takes connection, waiting for up to timeout if there is none. Waiting thread is queued after other waiters of the
+   * same or higher priority, and gets connections only after them.
+   *
+   * @param timeout time to wait
+   * @param priority priority class of the request, 0 is the highest
+   * @return connection or nullptr, if none has become available in time, or if the stack is closed
+   */
+  IdleStack::Item IdleStack::poll(const ::mariadb::Timer::Clock::duration& timeout, std::size_t priority)
+  {
+    Item item= take();
+
+    if (item != nullptr || timeout == ::mariadb::Timer::Clock::duration(0)) {
+      return item;
+    }
+
+    ::mariadb::Timer t(timeout);
+    Waiter waiter(std::min(priority, PRIORITY_CLASSES - 1));
+    ++waiters;
+    {
+      std::unique_lock<std::mutex> localScopeLock(waitLock);
+      if (!closed.load() && (item= take()) == nullptr) {
+        std::deque<Waiter*>& queue= waitQueues[waiter.priority];
+        queue.push_back(&waiter);
+        while (waiter.item == nullptr && !closed.load() && !t.over()) {
+          waiter.wakeUp.wait_for(localScopeLock, t.left());
+        }
+        item= waiter.item;
+        // If the connection has not been handed over, the waiter is still in the queue
+        if (item == nullptr) {
+          queue.erase(std::find(queue.begin(), queue.end(), &waiter));
+        }
+      }
+    }
+    --waiters;
+
+    return item;
+  }
+
+  /* Number of queued waiters of the given or higher priority */
+  std::size_t IdleStack::getWaiterCount(std::size_t priority)
+  {
+    std::size_t count= 0;
+    std::lock_guard<std::mutex> localScopeLock(waitLock);
+
+    for (std::size_t i= 0; i <= priority && i < PRIORITY_CLASSES; ++i) {
+      count+= waitQueues[i].size();
+    }
+    return count;
+  }
+
+
+  /**
+   * Takes connections out of slots one by one, and calls action for each. Connection is put back into its slot,
+   * or into a shard if the owner has filled the slot meanwhile, if action returns true.
+   */
+  template <class ActionT> void IdleStack::forEachSlot(ActionT action)
+  {
+    for (auto& slot : slots) {
+      if (slot.load(std::memory_order_relaxed) == nullptr) {
+        continue;
+      }
+      Item item= slot.exchange(nullptr);
+      if (item == nullptr) {
+        continue;
+      }
+      --itemCount;
+      if (action(item)) {
+        Item expected= nullptr;
+        if (slot.compare_exchange_strong(expected, item)) {
+          ++itemCount;
+        }
+        else {
+          pushToShard(item);
+        }
+      }
+    }
+  }
+
+
+  bool IdleStack::remove(Item item)
+  {
+    return !removeIf([item](Item candidate) { return candidate == item; }).empty();
+  }
+
+
+  bool IdleStack::contains(Item item)
+  {
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> shardLock(shard->lock);
+      if (std::find(shard->items.begin(), shard->items.end(), item) != shard->items.end()) {
+        return true;
+      }
+    }
+    for (auto& slot : slots) {
+      if (slot.load() == item) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Removes connections, for which predicate returns true. Predicate is called with the shard lock held.
+   *
+   * @return removed connections
+   */
+  std::vector<IdleStack::Item> IdleStack::removeIf(const std::function<bool(Item)>& predicate)
+  {
+    std::vector<Item> removed;
+
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> shardLock(shard->lock);
+      auto it= std::stable_partition(shard->items.begin(), shard->items.end(), [&predicate](Item item) {
+        return !predicate(item);
+      });
+      std::size_t removedCount= shard->items.end() - it;
+
+      removed.insert(removed.end(), it, shard->items.end());
+      shard->items.erase(it, shard->items.end());
+      shard->count-= removedCount;
+      itemCount-= removedCount;
+    }
+    forEachSlot([&](Item item) -> bool {
+      if (predicate(item)) {
+        removed.push_back(item);
+        return false;
+      }
+      return true;
+    });
+    return removed;
+  }
+
+
+  std::vector<IdleStack::Item> IdleStack::drain()
+  {
+    return removeIf([](Item) { return true; });
+  }
+
+
+  void IdleStack::forEach(const std::function<void(Item)>& action)
+  {
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> shardLock(shard->lock);
+      for (Item item : shard->items) {
+        action(item);
+      }
+    }
+    forEachSlot([&action](Item item) -> bool {
+      action(item);
+      return true;
+    });
+  }
+
+  /* After close connections are not accepted and can't be taken, waiters return right away */
+  void IdleStack::close()
+  {
+    closed.store(true);
+    std::lock_guard<std::mutex> localScopeLock(waitLock);
+    for (auto& queue : waitQueues) {
+      for (Waiter* waiter : queue) {
+        waiter->wakeUp.notify_one();
+      }
+    }
+  }
+
+
+  std::size_t IdleStack::size() const
+  {
+    return itemCount.load(std::memory_order_relaxed);
+  }
+
+
+  bool IdleStack::empty() const
+  {
+    return size() == 0;
+  }
+}
+}
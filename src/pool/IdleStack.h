@@ -0,0 +1,123 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#ifndef _IDLESTACK_H_
+#define _IDLESTACK_H_
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "timer.h"
+
+namespace sql
+{
+namespace mariadb
+{
+class MariaDbInnerPoolConnection;
+
+/**
+ * Idle connections of the pool. Connections are kept in LIFO stacks, sharded by thread, so concurrent checkouts and
+ * returns of different threads mostly lock different, uncontended, mutexes, and the thread gets back the connection
+ * it has returned most recently. A thread takes from own shard first, and from other shards if own is empty.
+ * Only when all shards are empty the thread waits for a connection to be returned. Waiting threads are queued FIFO
+ * within their priority class, higher classes first, and returned connection is handed over directly to the first
+ * waiter, waking up only that thread.
+ * With thread affinity, a thread returning a connection parks it in its own slot, and gets it back from there on next
+ * checkout without locking anything. Other threads steal from slots only when no shard has a connection.
+ */
+class IdleStack
+{
+public:
+  /* Number of priority classes of waiters, 0 is the highest */
+  static const std::size_t PRIORITY_CLASSES= 3;
+
+private:
+  typedef MariaDbInnerPoolConnection* Item;
+
+  struct Shard
+  {
+    std::mutex lock;
+    std::vector<Item> items;
+    /* Readable without lock, to skip empty shards */
+    std::atomic<std::size_t> count{0};
+  };
+
+  std::vector<std::unique_ptr<Shard>> shards;
+  /* Per-thread last returned connection(threadAffinity). Empty if affinity is off */
+  std::vector<std::atomic<Item>> slots;
+  std::atomic<std::size_t> itemCount{0};
+
+  struct Waiter
+  {
+    std::condition_variable wakeUp;
+    std::size_t priority;
+    /* Connection handed over to the waiter */
+    Item item= nullptr;
+
+    Waiter(std::size_t _priority) : priority(_priority) {}
+  };
+  /* Number of threads waiting, or about to wait, for a connection */
+  std::atomic<int32_t> waiters{0};
+  /* Guards waitQueues */
+  std::mutex waitLock;
+  std::array<std::deque<Waiter*>, PRIORITY_CLASSES> waitQueues;
+  std::atomic<bool> closed{false};
+
+  IdleStack(const IdleStack&)= delete;
+  void operator=(const IdleStack&)= delete;
+
+  static std::size_t getThreadIndex();
+  std::size_t getHomeShard() const;
+  Item take();
+  Item stealFromSlots(std::size_t ownSlot);
+  void pushToShard(Item item);
+  Waiter* firstWaiter();
+  void wake(Waiter& waiter, Item item);
+  bool handTo(Item item);
+  void handOff();
+  template <class ActionT> void forEachSlot(ActionT action);
+
+public:
+  IdleStack(std::size_t maxSize, bool threadAffinity= false);
+
+  bool push(Item item, bool toOwnSlot= false);
+  Item poll();
+  Item poll(const ::mariadb::Timer::Clock::duration& timeout, std::size_t priority= 1);
+  std::size_t getWaiterCount(std::size_t priority);
+  bool remove(Item item);
+  bool contains(Item item);
+  std::vector<Item> removeIf(const std::function<bool(Item)>& predicate);
+  std::vector<Item> drain();
+  void forEach(const std::function<void(Item)>& action);
+  void close();
+  std::size_t size() const;
+  bool empty() const;
+};
+
+}
+}
+#endif
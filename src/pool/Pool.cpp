@@ -20,6 +20,7 @@
 
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 #include "ExceptionFactory.h"
 #include "Pools.h"
@@ -30,6 +31,7 @@
 #include "MariaDbThreadFactory.h"
 #include "util/Utils.h"
 #include "ConnectionEventListener.h"
+#include "GlobalStateCache.h"
 
 // Otherwise operations with time tend to be few screens wide
 using namespace std::chrono;
@@ -45,25 +47,26 @@ namespace mariadb
     *
     * @param urlParser configuration parser
     * @param poolIndex pool index to permit distinction of thread name
-    * @param poolExecutor pools common executor
+    * @param poolExecutor pools common executor, used to abort connections
     */
   Pool::Pool(Shared::UrlParser &_urlParser, int32_t poolIndex, ScheduledThreadPoolExecutor& _poolExecutor) :
     urlParser(_urlParser),
     options(urlParser->getOptions()),
     poolState(POOL_STATE_OK),
     //maxIdleTime(options->maxIdleTime),
-    connectionAppenderQueue(urlParser->getOptions()->maxPoolSize),
     poolTag(generatePoolTag(poolIndex)),
     connectionAppender(
         1,
         1,
-        std::chrono::seconds(10),
-        connectionAppenderQueue,
         new MariaDbThreadFactory(poolTag +"-appender")),
     poolExecutor(_poolExecutor),
     pendingRequestNumber(0),
     totalConnection(0),
-    scheduledFuture(nullptr)
+    idleConnections(urlParser->getOptions()->maxPoolSize, urlParser->getOptions()->poolThreadAffinity),
+    sizer(urlParser->getOptions()->minPoolSize, urlParser->getOptions()->maxPoolSize,
+      urlParser->getOptions()->poolSizingWindow, urlParser->getOptions()->poolMaxConnectRate),
+    idleCheckTimer(std::bind(&Pool::scheduleIdleCheck, this)),
+    sizingTimer(std::bind(&Pool::adjustSize, this))
   {
     connectionAppender.allowCoreThreadTimeOut(true);
 
@@ -73,24 +76,50 @@ namespace mariadb
       minDelay= std::stoi(cit->second.c_str());
     }
 
+    if (!options->poolWarmupStatements.empty()) {
+      Tokens statements= split(options->poolWarmupStatements, ";");
+      for (auto& statement : *statements) {
+        if (!statement.trim().empty()) {
+          warmupStatements.push_back(statement);
+        }
+      }
+    }
+
     try
     {
       addConnection();
       // Doing heave thing after first connection - so if it fails and throws, we throw further with light heart
       connectionAppender.prestartCoreThread();
       int32_t scheduleDelay= std::min(minDelay, options->maxIdleTime / 2);
-      scheduledFuture.reset(
-        poolExecutor.scheduleAtFixedRate(
-          std::bind(&Pool::removeIdleTimeoutConnection, this), std::chrono::seconds(scheduleDelay),
-          std::chrono::seconds(scheduleDelay)));
-      for (int32_t i= 1; i < options->minPoolSize; ++i) {
+      TimerWheel::getInstance().schedule(idleCheckTimer, std::chrono::seconds(scheduleDelay),
+        std::chrono::seconds(scheduleDelay));
+      if (options->poolAdaptiveSizing) {
+        TimerWheel::getInstance().schedule(sizingTimer, PoolSizer::TICK, PoolSizer::TICK);
+      }
+      prefill(options->minPoolSize - 1);
+      // Whatever prefill could not create, is left to the appender
+      for (int32_t i= totalConnection.load(); i < options->minPoolSize; ++i) {
         addConnectionRequest();
       }
-      if (!idleConnections.empty()) {
-        Unique::Statement stmt(idleConnections.front()->getConnection()->createStatement());
-        Unique::ResultSet rs(stmt->executeQuery("SELECT @@wait_timeout"));
-        if (rs->next()) {
-          waitTimeout= rs->getUInt(1);
+      MariaDbInnerPoolConnection* first= idleConnections.poll();
+      if (first != nullptr) {
+        // Putting back right away, so the connection is available while the query is running
+        idleConnections.push(first);
+        MariaDbConnection* connection= dynamic_cast<MariaDbConnection*>(first->getConnection());
+        Shared::Protocol& protocol= connection->getProtocol();
+        GlobalStateInfo globalInfo;
+
+        if (options->staticGlobal &&
+          GlobalStateCache::get(GlobalStateCache::getKey(protocol->getUsername(), protocol->getHost(),
+            protocol->getPort(), options->sessionVariables), globalInfo)) {
+          waitTimeout= globalInfo.getWaitTimeout();
+        }
+        else {
+          Unique::Statement stmt(connection->createStatement());
+          Unique::ResultSet rs(stmt->executeQuery("SELECT @@wait_timeout"));
+          if (rs->next()) {
+            waitTimeout= rs->getUInt(1);
+          }
         }
       }
     }
@@ -105,10 +134,11 @@ namespace mariadb
   Pool::~Pool()
   {
     GET_LOGGER()->trace("Pool", "Pool::~Pool");
-    scheduledFuture->cancel(true);
+    TimerWheel::getInstance().cancel(idleCheckTimer);
+    TimerWheel::getInstance().cancel(sizingTimer);
     connectionAppender.shutdown();
-    /* Normally that is done while pool is close()-ed. TODO: lock? */
-    for (auto& item : idleConnections)
+    /* Normally that is done while pool is close()-ed */
+    for (auto item : idleConnections.drain())
     {
       delete item;
     }
@@ -116,27 +146,94 @@ namespace mariadb
 
   /**
     * Add new connection if needed. Only one thread create new connection, so new connection request
-    * will wait to newly created connection or for a released connection.
+    * will wait to newly created connection or for a released connection. Requests are counted, and only the first
+    * one queues the appender task, that handles all requests counted by the time it finishes.
     */
   void Pool::addConnectionRequest()
   {
     if (totalConnection.load(std::memory_order_relaxed) < options->maxPoolSize &&
-        poolState.load(std::memory_order_relaxed) == POOL_STATE_OK)
+        poolState.load(std::memory_order_relaxed) == POOL_STATE_OK &&
+        connectionRequests.fetch_add(1) == 0)
     {
-      connectionAppender.prestartCoreThread();
-      connectionAppenderQueue.emplace_back(
-        [&]()->void{
+      connectionAppender.execute(
+        [this]()->void{
         logger->trace("Pool","Doing adding task");
-        if ((totalConnection.load() < options->minPoolSize || pendingRequestNumber.load() > 0)
-          && totalConnection.load() < options->maxPoolSize) {
+        for (int32_t requests= connectionRequests.load(); requests > 0; requests= (connectionRequests-= requests)) {
+          for (int32_t i= 0; i < requests; ++i) {
+            if ((totalConnection.load() < sizer.getTarget() || pendingRequestNumber.load() > 0)
+              && totalConnection.load() < options->maxPoolSize && poolState.load() == POOL_STATE_OK) {
+              try {
+                addConnection();
+              }
+              catch (sql::SQLException&)
+              {
+              }
+            }
+          }
+        }
+        logger->trace("Pool","Done adding task");
+      });
+    }
+  }
+
+  /**
+    * Opens connections in parallel, with up to MAX_PREFILL_THREADS threads, and waits for them. Thread stops at
+    * first failure, on the assumption that next attempts would most probably fail as well.
+    *
+    * @param count number of connections to open
+    */
+  void Pool::prefill(int32_t count)
+  {
+    if (count <= 0) {
+      return;
+    }
+    std::atomic<int32_t> remaining(count);
+    std::vector<std::thread> workers;
+
+    for (int32_t i= 0; i < std::min(count, MAX_PREFILL_THREADS); ++i) {
+      workers.emplace_back([this, &remaining]() {
+        while (remaining.fetch_sub(1) > 0 && totalConnection.load() < options->maxPoolSize) {
           try {
             addConnection();
           }
-          catch (sql::SQLException&)
-          {
+          catch (SQLException&) {
+            return;
           }
         }
-        logger->trace("Pool","Done adding task");
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  /**
+    * Prepares poolWarmupStatements on the new connection. Failure of a statement is logged, and does not make the
+    * connection unusable.
+    */
+  void Pool::warmUp(MariaDbConnection& connection)
+  {
+    for (auto& statement : warmupStatements) {
+      try {
+        std::unique_ptr<PreparedStatement> pstmt(connection.prepareStatement(statement));
+      }
+      catch (SQLException& e) {
+        logger->warn(poolTag + " could not prepare warm-up statement: " + StringImp::get(statement) + ": " + e.what());
+      }
+    }
+  }
+
+  /**
+    * Task of the idle check timer. Closing connections is network work, that must not hold up the timer wheel, thus it
+    * is handed over to the appender. Check is not queued again, while previous one has not finished.
+    */
+  void Pool::scheduleIdleCheck()
+  {
+    if (!checkingIdle.exchange(true)) {
+      connectionAppender.execute(
+        [this]()->void{
+        removeIdleTimeoutConnection();
+        checkingIdle.store(false);
       });
     }
   }
@@ -148,31 +245,25 @@ namespace mariadb
   void Pool::removeIdleTimeoutConnection()
   {
     logger->trace("Pool: Checking idles");
-    std::lock_guard<std::mutex> synchronized(idleConnections.getLock());
-
-    Idles::iterator iterator= idleConnections.begin();
-    MariaDbInnerPoolConnection* item;
-
-    while (iterator != idleConnections.end())
-    {
-      item= *iterator;
-      auto now= steady_clock::now();
-      //urlParser->getOptions()->maxIdleTime << "Now:" << now.time_since_epoch().count() << " Last used:" << item->getLastUsed().time_since_epoch().count() << " Diff:" << std::chrono::duration_cast<std::chrono::nanoseconds>(now - item->getLastUsed()).count() << "/" << std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::seconds(urlParser->getOptions()->maxIdleTime)).count();
-      auto idleNanos= duration_cast<nanoseconds>(now.time_since_epoch()).count() - item->getLastUsed();
-      bool timedOut= (idleNanos > duration_cast<nanoseconds>(seconds(urlParser->getOptions()->maxIdleTime)).count());
+    auto now= duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    auto maxIdleNanos= duration_cast<nanoseconds>(seconds(urlParser->getOptions()->maxIdleTime)).count();
+    auto waitTimeoutNanos= duration_cast<nanoseconds>(seconds(waitTimeout > 45U ? waitTimeout - 45U : waitTimeout)).count();
+
+    // Connections are only picked under the idle list lock, and closed after it's released
+    std::vector<MariaDbInnerPoolConnection*> removed= idleConnections.removeIf([&](MariaDbInnerPoolConnection* item) {
+      auto idleNanos= now - item->getLastUsed();
+      bool timedOut= (idleNanos > maxIdleNanos);
       bool shouldBeReleased= false;
-      MariaDbConnection* con= dynamic_cast<MariaDbConnection*>(item->getConnection());
 
       if (waitTimeout > 0) {
 
         // idle time is reaching server @@wait_timeout
-        if (idleNanos >
-          duration_cast<nanoseconds>(seconds(waitTimeout > 45U ? waitTimeout - 45U : waitTimeout)).count()) {
+        if (idleNanos > waitTimeoutNanos) {
           shouldBeReleased= true;
         }
 
-        //  idle has reach option maxIdleTime value and pool has more connections than minPoolSiz
-        if (timedOut && totalConnection.load() > options->minPoolSize) {
+        //  idle has reach option maxIdleTime value and pool has more connections than minPoolSize(or adaptive target)
+        if (timedOut && totalConnection.load() > sizer.getTarget()) {
           shouldBeReleased= true;
         }
 
@@ -183,25 +274,92 @@ namespace mariadb
 
       if (shouldBeReleased) {
         --totalConnection;
-        silentCloseConnection(*con);
-        delete item;
-        iterator= idleConnections.erase(iterator);
-        
-        addConnectionRequest();
-        if (logger->isDebugEnabled()) {
-          std::ostringstream s(poolTag);
-          s << " connection removed due to inactivity (total:" << totalConnection.load(std::memory_order_relaxed) <<
-            ", active:" << getActiveConnections() << ", pending:" << pendingRequestNumber.load(std::memory_order_relaxed) << ")";
-          logger->debug(s.str());
-        }
       }
-      else {
-        ++iterator;
+      return shouldBeReleased;
+    });
+
+    for (auto item : removed) {
+      MariaDbConnection* con= dynamic_cast<MariaDbConnection*>(item->getConnection());
+      silentCloseConnection(*con);
+      delete item;
+
+      addConnectionRequest();
+      if (logger->isDebugEnabled()) {
+        std::ostringstream s(poolTag);
+        s << " connection removed due to inactivity (total:" << totalConnection.load(std::memory_order_relaxed) <<
+          ", active:" << getActiveConnections() << ", pending:" << pendingRequestNumber.load(std::memory_order_relaxed) << ")";
+        logger->debug(s.str());
       }
     }
     GET_LOGGER()->trace("Pool: Done checking idles");
   }
 
+  /**
+    * Periodic task of adaptive sizing, runs in the timer wheel thread. Grows the pool to the sizer's target, or closes
+    * the least recently used idle connection, if the pool is bigger than the target. Both are done in the appender
+    * thread. Only one connection per tick is closed, so the pool shrinks gradually.
+    */
+  void Pool::adjustSize()
+  {
+    if (poolState.load() != POOL_STATE_OK) {
+      return;
+    }
+    int32_t target= sizer.tick(static_cast<int32_t>(getActiveConnections()) + pendingRequestNumber.load(std::memory_order_relaxed),
+      metrics.acquiresWaited.load(std::memory_order_relaxed));
+    int32_t total= totalConnection.load();
+
+    if (total < target) {
+      if (!growing.exchange(true)) {
+        connectionAppender.prestartCoreThread();
+        connectionAppender.execute(
+          [this]()->void{
+          try {
+            while (totalConnection.load() < sizer.getTarget() && poolState.load() == POOL_STATE_OK) {
+              addConnection();
+            }
+          }
+          catch (sql::SQLException&)
+          {
+          }
+          growing.store(false);
+        });
+      }
+    }
+    else if (total > target) {
+      if (!shrinking.exchange(true)) {
+        connectionAppender.execute(
+          [this]()->void{
+          removeOldestIdleConnection();
+          shrinking.store(false);
+        });
+      }
+    }
+  }
+
+
+  void Pool::removeOldestIdleConnection()
+  {
+    MariaDbInnerPoolConnection* oldest= nullptr;
+    idleConnections.forEach([&oldest](MariaDbInnerPoolConnection* item) {
+      if (oldest == nullptr || item->getLastUsed() < oldest->getLastUsed()) {
+        oldest= item;
+      }
+    });
+    // Connection could be taken meanwhile
+    if (oldest != nullptr && idleConnections.remove(oldest)) {
+      --totalConnection;
+      MariaDbConnection* con= dynamic_cast<MariaDbConnection*>(oldest->getConnection());
+      silentCloseConnection(*con);
+      delete oldest;
+      if (logger->isDebugEnabled()) {
+        std::ostringstream s(poolTag);
+        s << " connection removed due to lower demand (total:" << totalConnection.load(std::memory_order_relaxed) <<
+          ", target:" << sizer.getTarget() << ", active:" << getActiveConnections() << ")";
+        logger->debug(s.str());
+      }
+    }
+  }
+
   /**
     * Create new connection.
     *
@@ -209,8 +367,20 @@ namespace mariadb
     */
   void Pool::addConnection() {
 
-    Shared::Protocol protocol= Utils::retrieveProxy(urlParser, nullptr/*&globalInfo*/);
+    sizer.throttle();
+    auto start= steady_clock::now();
+    Shared::Protocol protocol;
+    try {
+      protocol= Utils::retrieveProxy(urlParser, nullptr/*&globalInfo*/);
+    }
+    catch (SQLException&) {
+      ++metrics.connectionsCreationFailed;
+      throw;
+    }
+    metrics.connectTime.record(steady_clock::now() - start);
+    ++metrics.connectionsCreated;
     MariaDbConnection* connection= new MariaDbConnection(protocol);
+    warmUp(*connection);
     MariaDbInnerPoolConnection* item(new MariaDbInnerPoolConnection(connection));
 
     item->addConnectionEventListener(new MariaDbConnectionEventListener(std::bind(&Pool::connectionClosed, this, std::placeholders::_1),
@@ -228,17 +398,19 @@ namespace mariadb
       connection->setDefaultTransactionIsolation(connection->getTransactionIsolation());
     }*/
 
-    if (poolState.load() == POOL_STATE_OK
-      && (++totalConnection) <= options->maxPoolSize) {
-      idleConnections.push(item);
-
-      if (logger->isDebugEnabled()) {
-        std::ostringstream s(poolTag);
-        s << " new physical connection created (total:" << totalConnection.load(std::memory_order_relaxed) <<
-          ", active:" << getActiveConnections() << ", pending:" << pendingRequestNumber.load(std::memory_order_relaxed) << ")";
-        logger->debug(s.str());
+    if (poolState.load() == POOL_STATE_OK) {
+      if ((++totalConnection) > options->maxPoolSize || !idleConnections.push(item)) {
+        --totalConnection;
+      }
+      else {
+        if (logger->isDebugEnabled()) {
+          std::ostringstream s(poolTag);
+          s << " new physical connection created (total:" << totalConnection.load(std::memory_order_relaxed) <<
+            ", active:" << getActiveConnections() << ", pending:" << pendingRequestNumber.load(std::memory_order_relaxed) << ")";
+          logger->debug(s.str());
+        }
+        return;
       }
-      return;
     }
 
     silentCloseConnection(*connection);
@@ -254,36 +426,26 @@ namespace mariadb
   /**
     * Get an existing idle connection in pool.
     *
+    * @param timeout time to wait for a connection
+    * @param priority priority class of the request, if it has to wait
     * @return an IDLE connection.
     */
-  MariaDbInnerPoolConnection* Pool::getIdleConnection(const ::mariadb::Timer::Clock::duration& timeout) {
+  MariaDbInnerPoolConnection* Pool::getIdleConnection(const ::mariadb::Timer::Clock::duration& timeout, std::size_t priority) {
 
     while (true) {
       auto item= 
         (timeout == ::mariadb::Timer::Duration(0))
-        ? idleConnections.pollFirst()
-        : idleConnections.pollFirst(timeout);
+        ? idleConnections.poll()
+        : idleConnections.poll(timeout, priority);
 
       if (item) {
         MariaDbConnection* connection= dynamic_cast<MariaDbConnection*>(item->getConnection());
         try {
-          if (duration_cast<milliseconds>(nanoseconds(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() -
-            item->getLastUsed())).count() > urlParser->getOptions()->poolValidMinDelay) {
-            // validate connection
-            if (connection->isValid(10)) { // 10 seconds timeout
-              // It's probably not quite right to operate here with MariaDbConnection
-              connection->markClosed(false);
-              item->lastUsedToNow();
-              GET_LOGGER()->trace("Pool Connection Closed:", connection->isClosed(), "getting idle 2", std::hex, item, "Protocol:", connection->getProtocol().get(),
-                "expClosed:", connection->getProtocol()->isExplicitClosed());
-              return item;
-            }
-          }
-          else {
-            // connection has been retrieved recently -> skip connection validation
+          if (validate(*item, *connection)) {
+            // It's probably not quite right to operate here with MariaDbConnection
             connection->markClosed(false);
             item->lastUsedToNow();
-            GET_LOGGER()->trace("Pool", connection->isClosed(), "getting idle 2", std::hex, item, "Protocol:", connection->getProtocol().get(),
+            GET_LOGGER()->trace("Pool Connection Closed:", connection->isClosed(), "getting idle 2", std::hex, item, "Protocol:", connection->getProtocol().get(),
               "expClosed:", connection->getProtocol()->isExplicitClosed());
             return item;
           }
@@ -310,7 +472,65 @@ namespace mariadb
     }
   }
 
+  /**
+   * Checks if idle connection can be given to the caller, using the cheapest check, that is sufficient.
+   * - connection used less than poolValidMinDelay ago is accepted as is, unless marked for validation.
+   * - socket is checked locally, without a round trip. Data or EOF on the socket of an idle connection means
+   *   the server has closed it(wait_timeout, KILL, restart) or has sent something unsolicited.
+   * - connection idle longer than server's wait_timeout is discarded, and the one idle less than half of it
+   *   is accepted without COM_PING.
+   * - in all other cases COM_PING is sent.
+   *
+   * @param item        pool item
+   * @param connection  connection of that item
+   * @return true if connection can be used
+   */
+  bool Pool::validate(MariaDbInnerPoolConnection& item, MariaDbConnection& connection)
+  {
+    int64_t lastUsed= item.getLastUsed();
+    int64_t idleNanos= duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() - lastUsed;
+
+    if (lastUsed != 0 && duration_cast<milliseconds>(nanoseconds(idleNanos)).count() <= options->poolValidMinDelay) {
+      // connection has been retrieved recently -> skip connection validation
+      return true;
+    }
+
+    if (options->poolLocalValidation) {
+      ++metrics.socketChecks;
+      if (connection.getProtocol()->isSocketClosed()) {
+        ++metrics.socketChecksFailed;
+        return false;
+      }
+      if (lastUsed != 0 && waitTimeout > 0) {
+        auto waitTimeoutNanos= duration_cast<nanoseconds>(seconds(waitTimeout)).count();
+        if (idleNanos >= waitTimeoutNanos) {
+          ++metrics.expiredByAge;
+          return false;
+        }
+        if (idleNanos < waitTimeoutNanos / 2) {
+          ++metrics.pingsAvoided;
+          return true;
+        }
+      }
+    }
+
+    auto start= steady_clock::now();
+    bool valid= false;
+    ++metrics.validations;
+    try {
+      valid= connection.isValid(10); // 10 seconds timeout
+    }
+    catch (SQLException&) {
+    }
+    metrics.validationTime.record(steady_clock::now() - start);
+    if (!valid) {
+      ++metrics.validationsFailed;
+    }
+    return valid;
+  }
+
   void Pool::silentCloseConnection(MariaDbConnection& con) {
+    ++metrics.connectionsClosed;
     con.setPoolConnection(nullptr);
     try {
       con.close();
@@ -320,6 +540,7 @@ namespace mariadb
   }
 
   void Pool::silentAbortConnection(MariaDbInnerPoolConnection& item) {
+    ++metrics.connectionsClosed;
     try {
       item.abort(&poolExecutor);
     }
@@ -386,35 +607,63 @@ namespace mariadb
   /**
     * Retrieve new connection. If possible return idle connection, if not, stack connection query,
     * ask for a connection creation, and loop until a connection become idle / a new connection is
-    * created.
+    * created. Waiting requests are served in FIFO order within the priority class, higher classes first.
+    * With poolFailFast option, when the pool is at maxPoolSize, request fails right away if the expected wait, that
+    * is estimated from number of requests ahead and the average time connections are held, exceeds connectTimeout.
     *
+    * @param priority priority of the request
     * @return a connection object
     * @throws SQLException if no connection is created when reaching timeout (connectTimeout option)
     */
-  MariaDbInnerPoolConnection* Pool::getPoolConnection()
+  MariaDbInnerPoolConnection* Pool::getPoolConnection(PoolPriority priority)
   {
-    ++pendingRequestNumber;
+    const std::size_t priorityClass= static_cast<std::size_t>(priority);
+    int32_t pending= ++pendingRequestNumber;
+    if (options->poolAdaptiveSizing) {
+      sizer.observe(static_cast<int32_t>(getActiveConnections()) + pending);
+    }
 
     MariaDbInnerPoolConnection *pooledConnection;
+    auto start= steady_clock::now();
 
     /*try*/ {
       // try to get Idle connection if any (with a very small timeout)
       if ((pooledConnection=
-        getIdleConnection(::mariadb::Timer::Clock::duration(std::chrono::microseconds(totalConnection.load() > 4 ? 0 : 50))))) {
+        getIdleConnection(::mariadb::Timer::Clock::duration(std::chrono::microseconds(totalConnection.load() > 4 ? 0 : 50)),
+          priorityClass))) {
         --pendingRequestNumber;
+        metrics.acquireTime.record(steady_clock::now() - start);
         return pooledConnection;
       }
+      int32_t total= totalConnection.load();
+      if (options->poolFailFast && total >= options->maxPoolSize) {
+        int64_t expectedWaitMicros= metrics.holdTime.getMeanMicros()*
+          static_cast<int64_t>(idleConnections.getWaiterCount(priorityClass) + 1) / std::max(total, 1);
+
+        if (expectedWaitMicros > static_cast<int64_t>(options->connectTimeout)*1000) {
+          --pendingRequestNumber;
+          ++metrics.acquiresRejected;
+          throw SQLException(
+            "No connection is expected to become available within the specified time of connectTimeout("
+            + std::to_string(options->connectTimeout)
+            + " ms), expected wait " + std::to_string(expectedWaitMicros / 1000) + " ms");
+        }
+      }
+      ++metrics.acquiresWaited;
 
       // ask for new connection creation if max is not reached
       addConnectionRequest();
 
       // try to create new connection
       if ((pooledConnection=
-        getIdleConnection(::mariadb::Timer::Clock::duration(std::chrono::milliseconds(urlParser->getOptions()->connectTimeout))))) {
+        getIdleConnection(::mariadb::Timer::Clock::duration(std::chrono::milliseconds(urlParser->getOptions()->connectTimeout)),
+          priorityClass))) {
         --pendingRequestNumber;
+        metrics.acquireTime.record(steady_clock::now() - start);
         return pooledConnection;
       }
       --pendingRequestNumber;
+      ++metrics.acquiresTimedOut;
       if (logger->isDebugEnabled()) {
         std::ostringstream s(poolTag);
         s << "Connection could not been got (total:" << totalConnection.load(std::memory_order_relaxed) <<
@@ -485,8 +734,11 @@ namespace mariadb
     //std::unique_lock<std::mutex> lock(listsLock);
     poolState.store(POOL_STATE_CLOSING);
     pendingRequestNumber.store(0);
+    // Releases threads waiting for a connection
+    idleConnections.close();
 
-    scheduledFuture->cancel(true);
+    TimerWheel::getInstance().cancel(idleCheckTimer);
+    TimerWheel::getInstance().cancel(sizingTimer);
     connectionAppender.shutdown();
 
     try
@@ -516,7 +768,7 @@ namespace mariadb
 
     auto start = std::chrono::high_resolution_clock::now();
     do {
-      closeAll(idleConnections);
+      closeAll();
       if (totalConnection.load() > 0) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
       }
@@ -525,7 +777,7 @@ namespace mariadb
           < 10);
 
     if (totalConnection.load() > 0 || idleConnections.empty()) {
-      closeAll(idleConnections);
+      closeAll();
     }
 
     Pools::remove(*this);
@@ -533,18 +785,12 @@ namespace mariadb
     connectionRemover.awaitTermination(10, TimeUnit::SECONDS);*/
   }
 
-  void Pool::closeAll(Idles &collection)
+  void Pool::closeAll()
   {
-    std::lock_guard<std::mutex> synchronized(collection.getLock());
-
-    for (auto item= collection.begin(); item != collection.end();) {
+    for (auto poolConn : idleConnections.drain()) {
       --totalConnection;
-      silentAbortConnection(**item);
-      auto poolConn= (*item);
-      /*auto conn= poolConn->getConnection();
-      delete conn;*/
+      silentAbortConnection(*poolConn);
       delete poolConn;
-      item= collection.erase(item);
     }
   }
 
@@ -638,16 +884,27 @@ namespace mariadb
     }
 
 
+    void Pool::getStatistics(PoolStatistics& statistics)
+    {
+      metrics.snapshot(statistics);
+      statistics.totalConnections= getTotalConnections();
+      statistics.idleConnections= getIdleConnections();
+      statistics.activeConnections= statistics.totalConnections - statistics.idleConnections;
+      statistics.pendingRequests= getConnectionRequests();
+      statistics.targetConnections= sizer.getTarget();
+    }
+
+
     /**
       * For testing purpose only.
       *
       * @return current thread id's
       */
     std::vector<int64_t> Pool::testGetConnectionIdleThreadIds() {
-      std::vector<int64_t> threadIds(idleConnections.size());
-      for (auto it= idleConnections.begin(); it != idleConnections.end(); ++it) {
-        threadIds.push_back((dynamic_cast<MariaDbConnection*>((*it)->getConnection()))->getServerThreadId());
-      }
+      std::vector<int64_t> threadIds;
+      idleConnections.forEach([&threadIds](MariaDbInnerPoolConnection* item) {
+        threadIds.push_back((dynamic_cast<MariaDbConnection*>(item->getConnection()))->getServerThreadId());
+      });
       return threadIds;
     }
 
@@ -656,26 +913,26 @@ namespace mariadb
     {
       MariaDbInnerPoolConnection &item= dynamic_cast<MariaDbInnerPoolConnection&>(event.getSource());
       MariaDbConnection& conn = *dynamic_cast<MariaDbConnection*>(item.getConnection());
+      auto now= steady_clock::now();
+      int64_t checkedOut= item.getLastUsed();
 
+      // lastUsed is the time of checkout, unless the connection has been marked for validation
+      if (checkedOut > 0) {
+        metrics.holdTime.record(now.time_since_epoch() - nanoseconds(checkedOut));
+      }
       if (poolState.load() == POOL_STATE_OK) {
         try {
-          bool contains= false;
-          {
-            std::lock_guard<std::mutex> synchronized(idleConnections.getLock());
-            
-            for (Idles::iterator it= idleConnections.begin(); it != idleConnections.end(); ++it) {
-              if (*it == &item) {
-                contains= true;
-                break;
-              }
-            }
-          } // need to release the lock as push_back will obtain it, and it is not re-entrant
-          if (!contains) {
+          if (!idleConnections.contains(&item)) {
             MariaDbConnection& newConn= *item.makeFreshConnectionObj();
             newConn.setPoolConnection(nullptr);
-            newConn.reset();
+            newConn.resetForReuse();
+            metrics.resetTime.record(steady_clock::now() - now);
             newConn.setPoolConnection(&item);
-            idleConnections.push_back(&item);
+            if (!idleConnections.push(&item, true)) {
+              // The pool has been closed in the meantime
+              --totalConnection;
+              silentCloseConnection(newConn);
+            }
           }
         }
         catch (SQLException & /*sqle*/) {
@@ -690,6 +947,7 @@ namespace mariadb
       }
       else {
         // pool is closed, should then not be rendered to pool, but closed.
+        ++metrics.connectionsClosed;
         try {
           conn.setPoolConnection(nullptr);
           conn.close();
@@ -708,19 +966,10 @@ namespace mariadb
       MariaDbConnection& conn= *dynamic_cast<MariaDbConnection*>(item.getConnection());
 
       --totalConnection;
-      {
-        std::lock_guard<std::mutex> synchronized(idleConnections.getLock());
-        for (auto it= idleConnections.begin(); it != idleConnections.end(); std::advance(it, 1)) {
-          if (*it == &item) {
-            idleConnections.erase(it);
-            break;
-          }
-        }
-        // Erase (in the middle) invalidates all iterators, thus need new
-        for (auto const& it : idleConnections) {
-          it->ensureValidation();
-        }
-      } // lock can be freed by now
+      idleConnections.remove(&item);
+      idleConnections.forEach([](MariaDbInnerPoolConnection* idle) {
+        idle->ensureValidation();
+      });
       silentCloseConnection(conn);
       addConnectionRequest();
       std::ostringstream msg("connection ", std::ios_base::ate);
@@ -32,6 +32,10 @@
 #include "GlobalStateInfo.h"
 #include "MariaDbConnection.h"
 #include "ThreadPoolExecutor.h"
+#include "TimerWheel.h"
+#include "IdleStack.h"
+#include "PoolMetrics.h"
+#include "PoolSizer.h"
 #include "MariaDbInnerPoolConnection.h"
 #include "util/BlockingQueue.h"
 #include "ConnectionEventListener.h"
@@ -46,30 +50,41 @@ class MariaDbConnection;
 
 class Pool
 {
-  typedef sql::blocking_deque<MariaDbInnerPoolConnection*> Idles;
   static Logger* logger;
   static const int32_t POOL_STATE_OK= 0;
   static const int32_t POOL_STATE_CLOSING= 1;
+  /* Maximum number of threads opening connections in parallel at pool creation */
+  static const int32_t MAX_PREFILL_THREADS= 8;
   std::atomic<int32_t> poolState;
 
   Shared::UrlParser urlParser;
   const Shared::Options options;
   std::atomic<int32_t> pendingRequestNumber;
   std::atomic<int32_t> totalConnection;
-  Idles idleConnections;
-  /* Queue must go before appender */
-  sql::blocking_deque<Runnable> connectionAppenderQueue;
+  IdleStack idleConnections;
+  PoolMetrics metrics;
+  PoolSizer sizer;
+  /* Set while appender is growing the pool to the sizer's target */
+  std::atomic<bool> growing{false};
+  /* Set while idle connections check is queued or running in the appender */
+  std::atomic<bool> checkingIdle{false};
+  /* Set while closing of the oldest idle connection is queued or running in the appender */
+  std::atomic<bool> shrinking{false};
+  /* Connection requests not handled by the appender yet. Only the first of them queues the task */
+  std::atomic<int32_t> connectionRequests{0};
   // poolTag must be before connectionAppender
   std::string poolTag;
-  ThreadPoolExecutor connectionAppender;
+  WorkStealingExecutor connectionAppender;
   ScheduledThreadPoolExecutor& poolExecutor;
-  std::unique_ptr<ScheduledFuture> scheduledFuture;
+  TimerWheel::Timer idleCheckTimer;
+  TimerWheel::Timer sizingTimer;
   /*GlobalStateInfo globalInfo;
   int32_t maxIdleTime;
   int64_t timeToConnectNanos;
   int64_t connectionTime;*/
   std::mutex listsLock;
   uint32_t waitTimeout= 28800;
+  std::vector<SQLString> warmupStatements;
 
 public:
   Pool(Shared::UrlParser& _urlParser, int32_t poolIndex, ScheduledThreadPoolExecutor& poolExecutor);
@@ -77,17 +92,23 @@ public:
 
 private:
   void addConnectionRequest();
+  void scheduleIdleCheck();
   void removeIdleTimeoutConnection();
+  void adjustSize();
+  void removeOldestIdleConnection();
   void addConnection();
+  void prefill(int32_t count);
+  void warmUp(MariaDbConnection& connection);
   MariaDbInnerPoolConnection* getIdleConnection();
-  MariaDbInnerPoolConnection* getIdleConnection(const ::mariadb::Timer::Clock::duration& timeout);
+  MariaDbInnerPoolConnection* getIdleConnection(const ::mariadb::Timer::Clock::duration& timeout, std::size_t priority= 1);
   void silentCloseConnection(MariaDbConnection& item);
   void silentAbortConnection(MariaDbInnerPoolConnection& item);
+  bool validate(MariaDbInnerPoolConnection& item, MariaDbConnection& connection);
 
   //MariaDbInnerPoolConnection& createPoolConnection(MariaDbConnection* connection);
 
 public:
-  MariaDbInnerPoolConnection* getPoolConnection();
+  MariaDbInnerPoolConnection* getPoolConnection(PoolPriority priority= PoolPriority::NORMAL);
   MariaDbInnerPoolConnection* getPoolConnection(const SQLString& username, const SQLString& password);
 
 private:
@@ -98,7 +119,7 @@ public:
   void close();
 
 private:
-  void closeAll(Idles& collection);
+  void closeAll();
   //void initializePoolGlobalState(MariaDbConnection& connection);
 
 public:
@@ -110,6 +131,7 @@ public:
   int64_t getTotalConnections();
   int64_t getIdleConnections();
   int64_t getConnectionRequests();
+  void getStatistics(PoolStatistics& statistics);
 
   std::vector<int64_t> testGetConnectionIdleThreadIds();
 
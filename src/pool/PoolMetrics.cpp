@@ -0,0 +1,99 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include "PoolMetrics.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  PoolHistogramRecorder::PoolHistogramRecorder()
+  {
+    for (auto& bucket : buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+
+  void PoolHistogramRecorder::record(const std::chrono::nanoseconds& duration)
+  {
+    int64_t micros= std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    int32_t bucket= 0;
+
+    if (micros < 0) {
+      micros= 0;
+    }
+    // Number of significant bits is the bucket index
+    for (int64_t rest= micros; rest > 0 && bucket < PoolHistogram::BUCKETS - 1; rest>>= 1) {
+      ++bucket;
+    }
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    totalMicros.fetch_add(micros, std::memory_order_relaxed);
+
+    int64_t currentMax= maxMicros.load(std::memory_order_relaxed);
+    while (micros > currentMax && !maxMicros.compare_exchange_weak(currentMax, micros, std::memory_order_relaxed)) {
+    }
+  }
+
+  /* Returns 0 if nothing has been recorded */
+  int64_t PoolHistogramRecorder::getMeanMicros() const
+  {
+    int64_t recorded= count.load(std::memory_order_relaxed);
+    return recorded > 0 ? totalMicros.load(std::memory_order_relaxed) / recorded : 0;
+  }
+
+  /* Values are read one by one, thus the snapshot may be slightly inconsistent if something is being recorded */
+  void PoolHistogramRecorder::snapshot(PoolHistogram& histogram) const
+  {
+    histogram.count= 0;
+    for (int32_t i= 0; i < PoolHistogram::BUCKETS; ++i) {
+      histogram.buckets[i]= buckets[i].load(std::memory_order_relaxed);
+      histogram.count+= histogram.buckets[i];
+    }
+    histogram.totalMicros= totalMicros.load(std::memory_order_relaxed);
+    histogram.maxMicros= maxMicros.load(std::memory_order_relaxed);
+  }
+
+
+  void PoolMetrics::snapshot(PoolStatistics& statistics) const
+  {
+    statistics.connectionsCreated= connectionsCreated.load(std::memory_order_relaxed);
+    statistics.connectionsCreationFailed= connectionsCreationFailed.load(std::memory_order_relaxed);
+    statistics.connectionsClosed= connectionsClosed.load(std::memory_order_relaxed);
+    statistics.socketChecks= socketChecks.load(std::memory_order_relaxed);
+    statistics.socketChecksFailed= socketChecksFailed.load(std::memory_order_relaxed);
+    statistics.expiredByAge= expiredByAge.load(std::memory_order_relaxed);
+    statistics.pingsAvoided= pingsAvoided.load(std::memory_order_relaxed);
+    statistics.validations= validations.load(std::memory_order_relaxed);
+    statistics.validationsFailed= validationsFailed.load(std::memory_order_relaxed);
+    statistics.acquiresWaited= acquiresWaited.load(std::memory_order_relaxed);
+    statistics.acquiresTimedOut= acquiresTimedOut.load(std::memory_order_relaxed);
+    statistics.acquiresRejected= acquiresRejected.load(std::memory_order_relaxed);
+
+    acquireTime.snapshot(statistics.acquireTime);
+    holdTime.snapshot(statistics.holdTime);
+    connectTime.snapshot(statistics.connectTime);
+    validationTime.snapshot(statistics.validationTime);
+    resetTime.snapshot(statistics.resetTime);
+  }
+}
+}
@@ -0,0 +1,83 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#ifndef _POOLMETRICS_H_
+#define _POOLMETRICS_H_
+
+#include <atomic>
+#include <chrono>
+
+#include "MariaDbDataSource.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+/**
+ * Lock-free recorder of a duration distribution, PoolHistogram is its snapshot. Recording is a few relaxed atomic
+ * increments, so it can be done on every connection checkout.
+ */
+class PoolHistogramRecorder
+{
+  std::atomic<int64_t> count{0};
+  std::atomic<int64_t> totalMicros{0};
+  std::atomic<int64_t> maxMicros{0};
+  std::atomic<int64_t> buckets[PoolHistogram::BUCKETS];
+
+  PoolHistogramRecorder(const PoolHistogramRecorder&)= delete;
+  void operator=(const PoolHistogramRecorder&)= delete;
+
+public:
+  PoolHistogramRecorder();
+  void record(const std::chrono::nanoseconds& duration);
+  void snapshot(PoolHistogram& histogram) const;
+  int64_t getMeanMicros() const;
+};
+
+/** Counters and timings of one pool */
+struct PoolMetrics
+{
+  std::atomic<int64_t> connectionsCreated{0};
+  std::atomic<int64_t> connectionsCreationFailed{0};
+  std::atomic<int64_t> connectionsClosed{0};
+  std::atomic<int64_t> socketChecks{0};
+  std::atomic<int64_t> socketChecksFailed{0};
+  std::atomic<int64_t> expiredByAge{0};
+  std::atomic<int64_t> pingsAvoided{0};
+  std::atomic<int64_t> validations{0};
+  std::atomic<int64_t> validationsFailed{0};
+  std::atomic<int64_t> acquiresWaited{0};
+  std::atomic<int64_t> acquiresTimedOut{0};
+  std::atomic<int64_t> acquiresRejected{0};
+
+  PoolHistogramRecorder acquireTime;
+  PoolHistogramRecorder holdTime;
+  PoolHistogramRecorder connectTime;
+  PoolHistogramRecorder validationTime;
+  PoolHistogramRecorder resetTime;
+
+  /* Fills counters and histograms. Connection numbers are filled by the pool */
+  void snapshot(PoolStatistics& statistics) const;
+};
+
+}
+}
+#endif
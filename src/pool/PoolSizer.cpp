@@ -0,0 +1,127 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <algorithm>
+#include <thread>
+
+#include "PoolSizer.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  const std::chrono::seconds PoolSizer::TICK(1);
+
+  /**
+    * @param minSize        minimal pool size(minPoolSize)
+    * @param maxSize        maximal pool size(maxPoolSize)
+    * @param windowSeconds  length of the demand window in seconds
+    * @param maxConnectRate maximal number of connects per second, 0 means no limit
+    */
+  PoolSizer::PoolSizer(int32_t _minSize, int32_t _maxSize, int32_t windowSeconds, int32_t maxConnectRate) :
+    minSize(_minSize),
+    maxSize(_maxSize),
+    samples(std::max(static_cast<std::size_t>(windowSeconds / TICK.count()), RAMP_TICKS + 1), 0),
+    target(_minSize),
+    connectIntervalNanos(maxConnectRate > 0
+      ? std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::seconds(1)).count() / maxConnectRate
+      : 0)
+  {
+  }
+
+  /** Records current demand. Called on every checkout, thus it's a relaxed load in most cases */
+  void PoolSizer::observe(int32_t demand)
+  {
+    int32_t seen= peak.load(std::memory_order_relaxed);
+    while (demand > seen && !peak.compare_exchange_weak(seen, demand, std::memory_order_relaxed)) {
+    }
+  }
+
+
+  int32_t PoolSizer::getSample(std::size_t ticksAgo) const
+  {
+    return samples[(nextSample + samples.size() - 1 - ticksAgo) % samples.size()];
+  }
+
+  /**
+    * Closes current tick, and calculates new target size. Must not be called concurrently.
+    *
+    * @param demand          current demand, that becomes the starting peak of the next tick
+    * @param acquiresWaited  total number of requests, that had to wait for a connection so far
+    * @return new target size
+    */
+  int32_t PoolSizer::tick(int32_t demand, int64_t acquiresWaited)
+  {
+    int32_t tickPeak= std::max(peak.exchange(demand, std::memory_order_relaxed), demand);
+
+    samples[nextSample]= tickPeak;
+    nextSample= (nextSample + 1) % samples.size();
+    if (sampleCount < samples.size()) {
+      ++sampleCount;
+    }
+
+    int32_t wanted= 0;
+    for (std::size_t i= 0; i < sampleCount; ++i) {
+      wanted= std::max(wanted, getSample(i));
+    }
+    if (sampleCount > RAMP_TICKS) {
+      int32_t rise= tickPeak - getSample(RAMP_TICKS);
+      if (rise > 0) {
+        wanted= std::max(wanted, tickPeak + rise);
+      }
+    }
+    if (acquiresWaited > lastWaited) {
+      ++wanted;
+    }
+    lastWaited= acquiresWaited;
+
+    wanted= std::min(std::max(wanted, minSize), maxSize);
+    target.store(wanted, std::memory_order_relaxed);
+    return wanted;
+  }
+
+
+  int32_t PoolSizer::getTarget() const
+  {
+    return target.load(std::memory_order_relaxed);
+  }
+
+  /** Waits until opening of a new connection is allowed by poolMaxConnectRate */
+  void PoolSizer::throttle()
+  {
+    if (connectIntervalNanos == 0) {
+      return;
+    }
+    int64_t now= std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t next= nextConnect.load();
+    int64_t granted;
+
+    do {
+      granted= std::max(next, now);
+    } while (!nextConnect.compare_exchange_weak(next, granted + connectIntervalNanos));
+
+    if (granted > now) {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(granted - now));
+    }
+  }
+}
+}
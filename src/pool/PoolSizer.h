@@ -0,0 +1,75 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#ifndef _POOLSIZER_H_
+#define _POOLSIZER_H_
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace sql
+{
+namespace mariadb
+{
+/**
+ * Demand driven target size of the pool. The pool reports concurrent demand(connections in use plus pending
+ * requests) on every checkout, and calls tick() once per TICK. Peak demand of every tick is kept for the window
+ * of poolSizingWindow seconds. The target is the window's peak, raised ahead of a ramp by extrapolating the rise
+ * of the last RAMP_TICKS ticks, and by one more connection if requests had to wait. Since the target only goes down
+ * when the peak of a whole window is lower, lulls shorter than the window do not shrink the pool.
+ * Also limits the rate of opening new connections, if poolMaxConnectRate is set.
+ */
+class PoolSizer
+{
+  static const std::size_t RAMP_TICKS= 3;
+
+  const int32_t minSize;
+  const int32_t maxSize;
+  /* Peak demand of each tick of the window, ring buffer. Used by the thread calling tick() only */
+  std::vector<int32_t> samples;
+  std::size_t nextSample= 0;
+  std::size_t sampleCount= 0;
+  int64_t lastWaited= 0;
+  std::atomic<int32_t> peak{0};
+  std::atomic<int32_t> target;
+  /* Connection rate limit - minimal interval between connects, and the time the next connect is allowed at */
+  const int64_t connectIntervalNanos;
+  std::atomic<int64_t> nextConnect{0};
+
+  PoolSizer(const PoolSizer&)= delete;
+  void operator=(const PoolSizer&)= delete;
+
+  int32_t getSample(std::size_t ticksAgo) const;
+
+public:
+  static const std::chrono::seconds TICK;
+
+  PoolSizer(int32_t minSize, int32_t maxSize, int32_t windowSeconds, int32_t maxConnectRate);
+  void observe(int32_t demand);
+  int32_t tick(int32_t demand, int64_t acquiresWaited);
+  int32_t getTarget() const;
+  void throttle();
+};
+
+}
+}
+#endif
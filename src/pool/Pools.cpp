@@ -18,24 +18,47 @@
 *************************************************************************************/
 
 
+#include <vector>
+
 #include "Pools.h"
 #include "Pool.h"
 #include "ThreadPoolExecutor.h"
 #include "MariaDbThreadFactory.h"
+#include "protocol/ControlConnections.h"
 
 namespace sql
 {
 namespace mariadb
 {
+  const std::chrono::seconds Pools::RETIRED_MAP_GRACE(60);
   std::mutex Pools::mapLock;
   std::atomic<int32_t> Pools::poolIndex;
-  /* TODO: change to std::unordered_map */
-  HashMap<UrlParser, Shared::Pool> Pools::poolMap;
+  std::atomic<const Pools::PoolMap*> Pools::poolMap{nullptr};
+  std::deque<std::pair<std::chrono::steady_clock::time_point, std::unique_ptr<const Pools::PoolMap>>> Pools::retiredMaps;
   std::unique_ptr<ScheduledThreadPoolExecutor> Pools::poolExecutor;
-  
 
-  //const std::map<UrlParser&, Pool>poolMap;// =new ConcurrentHashMap<>();
-  /* ScheduledThreadPoolExecutor* Pools::poolExecutor= nullptr; */
+
+  const Pools::PoolMap* Pools::getMap()
+  {
+    return poolMap.load(std::memory_order_acquire);
+  }
+
+  /**
+    * Makes the new map current. The replaced map is retired, and maps retired longer than RETIRED_MAP_GRACE ago are
+    * freed. Must be called with mapLock held.
+    */
+  void Pools::publish(const PoolMap* newMap)
+  {
+    const PoolMap* replaced= poolMap.exchange(newMap, std::memory_order_acq_rel);
+    auto now= std::chrono::steady_clock::now();
+
+    while (!retiredMaps.empty() && now - retiredMaps.front().first > RETIRED_MAP_GRACE) {
+      retiredMaps.pop_front();
+    }
+    if (replaced != nullptr) {
+      retiredMaps.emplace_back(now, std::unique_ptr<const PoolMap>(replaced));
+    }
+  }
 
   /**
     * Get existing pool for a configuration. Create it if doesn't exists.
@@ -45,29 +68,74 @@ namespace mariadb
     */
   Shared::Pool Pools::retrievePool(Shared::UrlParser& urlParser)
   {
-    auto cit= poolMap.find(*urlParser);
-    if (cit == poolMap.end())
-    {
-      std::unique_lock<std::mutex> lock(mapLock);
-      {
-        // TODO: it should also check if the pool is active, i.e. not closing atm
-        cit= poolMap.find(*urlParser);
+    const PoolMap* pools= getMap();
 
-        if (cit == poolMap.end())
-        {
-          if (!poolExecutor)
-          {
-            poolExecutor.reset(new ScheduledThreadPoolExecutor(1, new MariaDbThreadFactory("MariaDbPool-maxTimeoutIdle-checker")));
-          }
-          Shared::Pool pool(new Pool(urlParser, ++poolIndex, *poolExecutor));
-          poolMap.insert(*urlParser, pool);
-
-          return pool;
-        }
+    if (pools != nullptr) {
+      auto cit= pools->find(*urlParser);
+      if (cit != pools->cend()) {
+        return cit->second;
+      }
+    }
+
+    std::unique_lock<std::mutex> lock(mapLock);
+    // TODO: it should also check if the pool is active, i.e. not closing atm
+    pools= getMap();
+    if (pools != nullptr) {
+      auto cit= pools->find(*urlParser);
+      if (cit != pools->cend()) {
+        return cit->second;
       }
     }
+    if (!poolExecutor)
+    {
+      poolExecutor.reset(new ScheduledThreadPoolExecutor(1, new MariaDbThreadFactory("MariaDbPool-connection-aborter")));
+    }
+    Shared::Pool pool(new Pool(urlParser, ++poolIndex, *poolExecutor));
+    PoolMap* updated= pools != nullptr ? new PoolMap(*pools) : new PoolMap();
+    updated->insert(*urlParser, pool);
+    publish(updated);
+
+    return pool;
+  }
 
-    return cit->second;
+  /**
+    * Get existing pool for a configuration. Unlike retrievePool, does not create it.
+    *
+    * @param urlParser configuration parser
+    * @return pool, or nullptr if there is no pool for this configuration
+    */
+  Shared::Pool Pools::find(const UrlParser& urlParser)
+  {
+    const PoolMap* pools= getMap();
+    if (pools == nullptr) {
+      return Shared::Pool();
+    }
+    auto cit= pools->find(urlParser);
+    return cit == pools->cend() ? Shared::Pool() : cit->second;
+  }
+
+  /**
+    * Get statistics of the pool with name defined in url.
+    *
+    * @param poolName the option "poolName" value
+    * @param statistics statistics to fill
+    * @return false, if there is no such pool
+    */
+  bool Pools::getStatistics(const SQLString& poolName, PoolStatistics& statistics)
+  {
+    const PoolMap* pools= getMap();
+    if (pools == nullptr) {
+      return false;
+    }
+    for (auto it= pools->cbegin(); it != pools->cend(); ++it)
+    {
+      if (poolName.compare(it->second->getUrlParser().getOptions()->poolName) == 0)
+      {
+        it->second->getStatistics(statistics);
+        return true;
+      }
+    }
+    return false;
   }
 
   /**
@@ -77,34 +145,53 @@ namespace mariadb
     */
   void Pools::remove(Pool &pool)
   {
-    if (poolMap.find(pool.getUrlParser()) != poolMap.end())
+    const PoolMap* pools= getMap();
+    if (pools == nullptr || pools->find(pool.getUrlParser()) == pools->cend())
     {
-      std::unique_lock<std::mutex> lock(mapLock);
-
-      if (poolMap.find(pool.getUrlParser()) != poolMap.end())
-      {
-        poolMap.remove(pool.getUrlParser());
-        if (poolMap.empty()) {
-          shutdownExecutor();
-        }
+      return;
+    }
+    std::unique_lock<std::mutex> lock(mapLock);
+    pools= getMap();
+    if (pools != nullptr && pools->find(pool.getUrlParser()) != pools->cend())
+    {
+      PoolMap* updated= new PoolMap(*pools);
+      updated->remove(pool.getUrlParser());
+      publish(updated);
+      if (updated->empty()) {
+        shutdownExecutor();
       }
     }
   }
 
-  /** Close all pools. */
+  /**
+    * Close all pools. Pools are taken out of the registry first, and closed without the lock, since closing pool
+    * removes it from the registry.
+    */
   void Pools::close()
   {
-    std::unique_lock<std::mutex> lock(mapLock);
-    for (auto it : poolMap)
+    std::vector<Shared::Pool> pools;
+    {
+      std::unique_lock<std::mutex> lock(mapLock);
+      const PoolMap* current= getMap();
+      if (current != nullptr) {
+        for (auto it= current->cbegin(); it != current->cend(); ++it) {
+          pools.push_back(it->second);
+        }
+      }
+      publish(nullptr);
+    }
+    for (auto& pool : pools)
     {
       try {
-        it.second->close();
+        pool->close();
       }
       catch (std::exception&) {
       }
     }
-    shutdownExecutor();
-    poolMap.clear();
+    std::unique_lock<std::mutex> lock(mapLock);
+    if (!getMap()) {
+      shutdownExecutor();
+    }
   }
 
   /**
@@ -119,31 +206,52 @@ namespace mariadb
       return;
     }
 
-    std::unique_lock<std::mutex> lock(mapLock);
-    for (auto it : poolMap)
+    Shared::Pool pool;
     {
-      if (poolName.compare(it.second->getUrlParser().getOptions()->poolName) == 0)
+      std::unique_lock<std::mutex> lock(mapLock);
+      const PoolMap* pools= getMap();
+      if (pools == nullptr) {
+        return;
+      }
+      for (auto it= pools->cbegin(); it != pools->cend(); ++it)
       {
-        try
-        {
-          it.second->close();
-        }
-        catch (std::exception&)
+        if (poolName.compare(it->second->getUrlParser().getOptions()->poolName) == 0)
         {
+          pool= it->second;
+          PoolMap* updated= new PoolMap(*pools);
+          updated->remove(pool->getUrlParser());
+          publish(updated);
+          break;
         }
-        poolMap.remove(it.second->getUrlParser());
-        return;
+      }
+    }
+    if (pool)
+    {
+      try
+      {
+        pool->close();
+      }
+      catch (std::exception&)
+      {
       }
     }
 
-    if (poolMap.empty())
+    std::unique_lock<std::mutex> lock(mapLock);
+    const PoolMap* pools= getMap();
+    if (pools == nullptr || pools->empty())
     {
       shutdownExecutor();
     }
   }
 
+  /* Called when the last pool is gone. Control connections, used to kill queries, are closed as well */
   void Pools::shutdownExecutor()
   {
+    ControlConnections::getInstance().clear();
+
+    if (!poolExecutor) {
+      return;
+    }
     poolExecutor->shutdown();
     try
     {
@@ -23,10 +23,14 @@
 #define _POOLS_H_
 
 #include <atomic>
+#include <chrono>
+#include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 
 #include "UrlParser.h"
+#include "MariaDbDataSource.hpp"
 #include "ThreadPoolExecutor.h"
 
 namespace sql
@@ -100,20 +104,37 @@ public:
 };
 
 
+/**
+ * Registry of pools. Lookup of an existing pool does not lock anything: the map of pools is never modified, but
+ * replaced under mapLock by a modified copy, when a pool is created or removed. Readers take the current map with an
+ * acquire load of a raw pointer. Replaced map is freed RETIRED_MAP_GRACE after it has been replaced - lookups are
+ * short, and no reader can still be using it by then.
+ */
 class Pools
 {
+  typedef HashMap<UrlParser, Shared::Pool> PoolMap;
+
+  static const std::chrono::seconds RETIRED_MAP_GRACE;
+
   static std::atomic<int32_t> poolIndex;
-  static HashMap<UrlParser,Shared::Pool> poolMap;
+  /* Current map of pools. nullptr if there is none */
+  static std::atomic<const PoolMap*> poolMap;
+  /* Replaced maps, oldest first, with the time they have been replaced. Guarded by mapLock */
+  static std::deque<std::pair<std::chrono::steady_clock::time_point, std::unique_ptr<const PoolMap>>> retiredMaps;
   static std::unique_ptr<ScheduledThreadPoolExecutor> poolExecutor;
   static std::mutex mapLock;
 
 public:
   static Shared::Pool retrievePool(Shared::UrlParser& urlParser);
+  static Shared::Pool find(const UrlParser& urlParser);
+  static bool getStatistics(const SQLString& poolName, PoolStatistics& statistics);
   static void remove(Pool& pool);
   static void close();
   static void close(const SQLString& poolName);
 
 private:
+  static const PoolMap* getMap();
+  static void publish(const PoolMap* newMap);
   static void shutdownExecutor();
 };
 
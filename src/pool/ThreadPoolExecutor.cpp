@@ -3,7 +3,9 @@
 
 #include "ThreadPoolExecutor.h"
 #include "MariaDbThreadFactory.h"
+#include "TimerWheel.h"
 #include <iostream>
+#include <list>
 
 namespace sql
 {
@@ -146,157 +148,264 @@ void ScheduledFuture::cancel(bool cancelType)
   }
 }
 
-//-------------------- ScheduledThreadPoolExecutor ---------------------
+//-------------------- WorkStealingExecutor ---------------------
 
-ScheduledFuture* ScheduledThreadPoolExecutor::scheduleAtFixedRate(std::function<void(void)> methodToRun,
-  ::mariadb::Timer::Clock::duration scheduleDelay, ::mariadb::Timer::Clock::duration delay2)
+thread_local WorkStealingExecutor* WorkStealingExecutor::currentExecutor= nullptr;
+thread_local std::size_t WorkStealingExecutor::currentWorker= 0;
+
+WorkStealingExecutor::WorkStealingExecutor(int32_t _corePoolSize, int32_t maxPoolSize, ThreadFactory* _threadFactory,
+  ::mariadb::Timer::Clock::duration _keepAliveTime)
+  : threadFactory(_threadFactory),
+  corePoolSize(std::max(_corePoolSize, 1)),
+  maximumPoolSize(maxPoolSize),
+  allowTimeout(false),
+  keepAliveTime(_keepAliveTime),
+  queuedTasks(0),
+  parkedWorkers(0),
+  workersCount(0),
+  workerAlive(new std::atomic<bool>[std::max(_corePoolSize, 1)]),
+  quit(false)
 {
-  ScheduledTask task(methodToRun,
-    static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(scheduleDelay).count()));
-  // TODO: can do better and insert it based on execution time
-  tasksQueue.push_back(task);
+  for (int32_t i= 0; i < corePoolSize; ++i) {
+    workerQueues.emplace_back(new TaskDeque());
+    workerAlive[i].store(false);
+  }
+  workers.reserve(corePoolSize);
+}
 
-  if (workersCount == 0) {
-    prestartCoreThread();
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+  shutdown();
+
+  for (auto& thr : workersList) {
+    thr.join();
   }
-  return new ScheduledFuture(task.canceled);
 }
 
 
-ScheduledThreadPoolExecutor::~ScheduledThreadPoolExecutor()
+/* Has to be set before the first task is submitted */
+void WorkStealingExecutor::allowCoreThreadTimeOut(bool value)
 {
-  for (auto& task : tasksQueue) {
-    if (task.canceled) {
-      task.canceled->store(true);
+  allowTimeout= value;
+}
+
+/* Starts workers, that have not been started yet, or have retired after keepAliveTime without work */
+bool WorkStealingExecutor::prestartCoreThread()
+{
+  std::lock_guard<std::mutex> localScopeLock(startLock);
+
+  for (std::size_t i= 0; i < static_cast<std::size_t>(corePoolSize) && !quit.load(); ++i) {
+    if (workerAlive[i].load()) {
+      continue;
+    }
+    if (i < workersList.size()) {
+      // The retired thread has nothing left to do but return
+      workersList[i].join();
+    }
+    else {
+      workers.emplace_back(std::bind(&WorkStealingExecutor::workerFunction, this, i));
+    }
+    workerAlive[i].store(true);
+    ++workersCount;
+    if (i < workersList.size()) {
+      workersList[i]= threadFactory->newThread(workers[i]);
+    }
+    else {
+      workersList.emplace_back(threadFactory->newThread(workers[i]));
     }
   }
-  shutdown();
+  return true;
+}
 
-  //this->awaitTermination(std::chrono::seconds(10));
 
-  for (auto& thr : workersList) {
-    thr.join();
+void WorkStealingExecutor::shutdown()
+{
+  if (!quit.load()) {
+    quit.store(true);
+    std::lock_guard<std::mutex> localScopeLock(parkLock);
+    workAvailable.notify_all();
   }
 }
 
 
-ScheduledThreadPoolExecutor::ScheduledThreadPoolExecutor(int32_t _corePoolSize, int32_t maxPoolSize, ThreadFactory* _threadFactory) :
-  corePoolSize(_corePoolSize),
-  maximumPoolSize(maxPoolSize),
-  workersCount(0),
-  worker(std::bind(&ScheduledThreadPoolExecutor::workerFunction, this)),
-  threadFactory(_threadFactory),
-  quit(false)
+template <class T, class P>
+bool WorkStealingExecutor::awaitTermination(std::chrono::duration<T, P> waitTime)
 {
+  return sql::awaitTermination<T, P>(waitTime, this->workersCount, workersList);
 }
 
-void ScheduledThreadPoolExecutor::workerFunction()
+
+void WorkStealingExecutor::execute(std::function<void()> func)
 {
-  const auto defaultTimeout= std::chrono::seconds(1);
-  ScheduledTask task;
+  execute(Runnable(func));
+}
+
+/* Task submitted from a worker of this executor goes to the worker's deque, otherwise to the injection queue */
+void WorkStealingExecutor::execute(Runnable code)
+{
+  if (quit.load()) {
+    return;
+  }
+  TaskDeque& queue= currentExecutor == this ? *workerQueues[currentWorker] : injectionQueue;
+  {
+    std::lock_guard<std::mutex> queueLock(queue.lock);
+    queue.tasks.push_back(code);
+  }
+  ++queuedTasks;
+
+  // Worker retires under parkLock, after it has seen no queued tasks. Reading workersCount under the same lock, either
+  // the worker sees this task, or it has retired already, and is started again here
+  bool startWorker;
+  if (allowTimeout) {
+    std::lock_guard<std::mutex> localScopeLock(parkLock);
+    startWorker= workersCount.load() < corePoolSize;
+  }
+  else {
+    startWorker= workersCount.load() < corePoolSize;
+  }
+  if (startWorker) {
+    prestartCoreThread();
+  }
 
-  //LoggerFactory::getLogger().trace("Pool", "Starting idles remover thread");
+  // Worker increments parkedWorkers before its last check of queuedTasks under parkLock, thus can't miss this task
+  if (parkedWorkers.load() > 0) {
+    std::lock_guard<std::mutex> localScopeLock(parkLock);
+    workAvailable.notify_one();
+  }
+}
 
-  while (!quit.load())
+
+bool WorkStealingExecutor::popFront(TaskDeque& queue, Runnable& task)
+{
+  std::lock_guard<std::mutex> queueLock(queue.lock);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+  task= queue.tasks.front();
+  queue.tasks.pop_front();
+  --queuedTasks;
+  return true;
+}
+
+/* Takes the newest task from own deque, then the oldest from injection queue, and then steals from other workers */
+bool WorkStealingExecutor::takeTask(std::size_t self, Runnable& task)
+{
+  if (queuedTasks.load() == 0) {
+    return false;
+  }
   {
-    //LoggerFactory::getLogger().trace("Pool", "Idles: quit not set, requesting task");
-    try {
-      tasksQueue.pop(task);
+    TaskDeque& own= *workerQueues[self];
+    std::lock_guard<std::mutex> queueLock(own.lock);
+    if (!own.tasks.empty()) {
+      task= own.tasks.back();
+      own.tasks.pop_back();
+      --queuedTasks;
+      return true;
     }
-    catch (InterruptedException&) {
-      //LoggerFactory::getLogger().trace("Pool", "Idles: queue is closed, pop() has thrown, breaking");
-      break;
+  }
+  if (popFront(injectionQueue, task)) {
+    return true;
+  }
+  for (std::size_t i= 1; i < workerQueues.size(); ++i) {
+    if (popFront(*workerQueues[(self + i) % workerQueues.size()], task)) {
+      return true;
     }
+  }
+  return false;
+}
 
-    if (task) {
-      //LoggerFactory::getLogger().trace("Pool", "Idles: valid task");
-      if (task.canceled && task.canceled->load()) {
-        //LoggerFactory::getLogger().trace("Pool", "Idles: canceled task, deleting");
-      }
-      else {
-        if (task.schedulePeriod.count() == 0) {
-          //LoggerFactory::getLogger().trace("Pool", "Idles: one time task, executing and deleting");
-          // One time task w/out schedule. Polling the next one right away
-          task.task.run();
-          break;
-        }
-        auto now = std::chrono::steady_clock::now();
 
-        if (now >= task.nextRunTime) {
-          //LoggerFactory::getLogger().trace("Pool", "Idles: scheduled due task, executing and rescheduling");
-          task.task.run();
-          task.nextRunTime = now + task.schedulePeriod;
-          tasksQueue.push_back(std::move(task));
-        }
-        else {
-          //LoggerFactory::getLogger().trace("Pool", "Idles: scheduled task, too early, pushing bacj to the queue");
-          // Push is like push_front
-          tasksQueue.push(std::move(task));
-        }
+void WorkStealingExecutor::workerFunction(std::size_t self)
+{
+  Runnable task;
 
-        if (task.schedulePeriod < defaultTimeout) {
-          //LoggerFactory::getLogger().trace("Pool", "Idles: sleeping remaining time");
-          std::this_thread::sleep_for(task.schedulePeriod);
-          break;
+  currentExecutor= this;
+  currentWorker= self;
+  while (!quit.load())
+  {
+    if (takeTask(self, task)) {
+      task.run();
+      continue;
+    }
+    ++parkedWorkers;
+    {
+      std::unique_lock<std::mutex> localScopeLock(parkLock);
+      auto retireAt= std::chrono::steady_clock::now() + keepAliveTime;
+
+      while (queuedTasks.load() == 0 && !quit.load()) {
+        if (!allowTimeout) {
+          workAvailable.wait(localScopeLock);
+        }
+        else if (workAvailable.wait_until(localScopeLock, retireAt) == std::cv_status::timeout &&
+          queuedTasks.load() == 0 && !quit.load()) {
+          --parkedWorkers;
+          workerAlive[self].store(false);
+          currentExecutor= nullptr;
+          --workersCount;
+          return;
         }
       }
     }
-    //LoggerFactory::getLogger().trace("Pool", "Idles: sleeping default time");
-    std::this_thread::sleep_for(defaultTimeout);
-    //LoggerFactory::getLogger().trace("Pool", "Idles: Checking if should  quit:", quit.load(), "<<<");
+    --parkedWorkers;
   }
+  currentExecutor= nullptr;
+  workerAlive[self].store(false);
   --workersCount;
-  //LoggerFactory::getLogger().trace("Pool", "Finishing idles remover thread execution, workersCount decremented");
 }
 
-bool ScheduledThreadPoolExecutor::prestartCoreThread()
+//-------------------- ScheduledThreadPoolExecutor ---------------------
+
+struct ScheduledThreadPoolExecutor::ScheduledTimers
 {
-  for (int32_t i = workersCount.load(); i < corePoolSize; ++i) {
-    workersList.emplace_back(threadFactory->newThread(worker));
-    //workersList.back().detach();
-    ++workersCount;
-  }
+  std::mutex lock;
+  std::list<mariadb::TimerWheel::Timer> timers;
+};
 
-  return true;
-}
 
-void ScheduledThreadPoolExecutor::execute(std::function<void()> func)
+ScheduledThreadPoolExecutor::ScheduledThreadPoolExecutor(int32_t _corePoolSize, int32_t maxPoolSize, ThreadFactory* _threadFactory) :
+  WorkStealingExecutor(_corePoolSize, maxPoolSize, _threadFactory),
+  timers(new ScheduledTimers())
 {
-  //tasksQueue.push(new ScheduledTask(func)); /*push= push_front*/
-  //if (workersCount == 0) {
-  //  prestartCoreThread();
-  //}
-  Runnable r(func);
-  execute(r);
 }
 
-void ScheduledThreadPoolExecutor::execute(Runnable code)
-{
-  ScheduledTask task(code);
-  tasksQueue.push(task);
-  if (workersCount == 0) {
-    prestartCoreThread();
-  }
-}
 
-void ScheduledThreadPoolExecutor::shutdown()
+ScheduledThreadPoolExecutor::~ScheduledThreadPoolExecutor()
 {
-  if (!quit.load()) {
-    //LoggerFactory::getLogger().trace("Pool", "Beginning to shut down idles remover thread");
-    quit.store(true);
-    tasksQueue.close();
-  }
+  shutdown();
 }
 
-template <class T, class P>
-bool ScheduledThreadPoolExecutor::awaitTermination(std::chrono::duration<T, P> waitTime)
+/**
+ * Runs the task in the executor periodically, first time after scheduleDelay.
+ *
+ * @return future, that can cancel the task. Caller owns it
+ */
+ScheduledFuture* ScheduledThreadPoolExecutor::scheduleAtFixedRate(std::function<void(void)> methodToRun,
+  ::mariadb::Timer::Clock::duration scheduleDelay, ::mariadb::Timer::Clock::duration period)
 {
-  return sql::awaitTermination<T, P>(waitTime, this->workersCount, workersList);
+  std::shared_ptr<std::atomic_bool> canceled(new std::atomic_bool(false));
+  std::lock_guard<std::mutex> localScopeLock(timers->lock);
+
+  timers->timers.emplace_back([this, canceled, methodToRun]() {
+    if (!canceled->load()) {
+      execute(methodToRun);
+    }
+  });
+  mariadb::TimerWheel::getInstance().schedule(timers->timers.back(), scheduleDelay, period);
+
+  return new ScheduledFuture(canceled);
 }
 
-ScheduledTask::operator bool() const
+
+void ScheduledThreadPoolExecutor::shutdown()
 {
-  return canceled && !canceled->load();
+  {
+    std::lock_guard<std::mutex> localScopeLock(timers->lock);
+    for (auto& timer : timers->timers) {
+      mariadb::TimerWheel::getInstance().cancel(timer);
+    }
+  }
+  WorkStealingExecutor::shutdown();
 }
 
-}
\ No newline at end of file
+}
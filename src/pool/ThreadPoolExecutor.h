@@ -27,6 +27,12 @@
 #include <functional>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "compat/Executor.hpp"
 #include "util/BlockingQueue.h"
 #include "MariaDbThreadFactory.h"
@@ -64,21 +70,6 @@ public:
 };
 
 
-struct ScheduledTask
-{
-  std::chrono::seconds schedulePeriod;
-  std::chrono::time_point<std::chrono::steady_clock> nextRunTime;
-  std::shared_ptr<std::atomic_bool> canceled;
-  Runnable task;
-
-  ScheduledTask(Runnable taskCode, uint32_t seconds= 0) : 
-    task(taskCode), schedulePeriod(seconds),
-    nextRunTime(std::chrono::steady_clock::now() + schedulePeriod),
-    canceled(new std::atomic_bool(false)) {}
-  ScheduledTask(std::atomic_bool* _canceled= nullptr) : canceled(_canceled), schedulePeriod(0) {}
-  explicit operator bool() const;
-};
-
 class ThreadPoolExecutor: public Executor {
   ThreadPoolExecutor(const ThreadPoolExecutor&);
   void operator=(ThreadPoolExecutor&);
@@ -116,37 +107,92 @@ public:
   void execute(std::function<void()> func);
 };
 
+// -------------------------------- WorkStealingExecutor ----------------------------------
+
+/**
+ * Executor with own deque of tasks for every worker, and a shared injection queue. Task submitted by a worker goes
+ * to its own deque, that the worker takes tasks from LIFO. Other tasks go to the injection queue. Worker, that has
+ * nothing in own deque, takes from the injection queue, and then steals FIFO from deques of other workers. Thus
+ * workers mostly lock own uncontended deque, and a submitter wakes up only one worker, and only if one is parked.
+ */
+class WorkStealingExecutor : public Executor
+{
+  WorkStealingExecutor(const WorkStealingExecutor&);
+  void operator=(WorkStealingExecutor&);
+  WorkStealingExecutor()=delete;
+
+  struct TaskDeque
+  {
+    std::mutex lock;
+    std::deque<Runnable> tasks;
+  };
+
+  /* Executor and index of the worker, that runs in the current thread */
+  static thread_local WorkStealingExecutor* currentExecutor;
+  static thread_local std::size_t currentWorker;
+
+protected:
+  std::unique_ptr<ThreadFactory> threadFactory;
+  int32_t corePoolSize;
+  int32_t maximumPoolSize;
+  bool allowTimeout;
+  /* With allowTimeout, worker parked for that long exits. It is started again by execute */
+  ::mariadb::Timer::Clock::duration keepAliveTime;
+  std::vector<std::unique_ptr<TaskDeque>> workerQueues;
+  TaskDeque injectionQueue;
+  /* Number of tasks in all queues */
+  std::atomic<int64_t> queuedTasks;
+  std::atomic<int32_t> parkedWorkers;
+  std::mutex parkLock;
+  std::condition_variable workAvailable;
+  std::mutex startLock;
+  std::atomic_int workersCount;
+  /* Threads get reference to their Runnable, thus the vector is reserved for all workers upfront */
+  std::vector<Runnable> workers;
+  /* Thread of every worker slot. Thread of a retired worker is joined, when the slot is started again */
+  std::vector<std::thread> workersList;
+  /* Whether the thread of the slot is running. Changed under parkLock by the worker, and under startLock on start */
+  std::unique_ptr<std::atomic<bool>[]> workerAlive;
+  std::atomic_bool quit;
+
+  bool popFront(TaskDeque& queue, Runnable& task);
+  bool takeTask(std::size_t self, Runnable& task);
+  void workerFunction(std::size_t self);
+
+public:
+  virtual ~WorkStealingExecutor();
+
+  WorkStealingExecutor(int32_t corePoolSize, int32_t maximumPoolSize, ThreadFactory* _threadFactory,
+    ::mariadb::Timer::Clock::duration keepAliveTime= std::chrono::seconds(10));
+  void allowCoreThreadTimeOut(bool value);
+  virtual bool prestartCoreThread();
+  virtual void shutdown();
+  template <class T, class P>
+  bool awaitTermination(std::chrono::duration<T,P> period);
+  void execute(Runnable code);
+  void execute(std::function<void()> func);
+};
+
 // -------------------------------- ScheduledThreadPoolExecutor ----------------------------------
 
-class ScheduledThreadPoolExecutor : public /*ThreadPool*/Executor
+/* Work stealing executor, that can also run tasks periodically. Periodic tasks are timed by the TimerWheel */
+class ScheduledThreadPoolExecutor : public WorkStealingExecutor
 {
   ScheduledThreadPoolExecutor(const ScheduledThreadPoolExecutor&);
   void operator=(ScheduledThreadPoolExecutor&);
   ScheduledThreadPoolExecutor() = delete;
 
-  std::unique_ptr<ThreadFactory> threadFactory;
-  blocking_deque<ScheduledTask> tasksQueue;
-  std::atomic_int workersCount;
-  std::atomic_bool quit;
-  std::vector<std::thread> workersList;
-  int32_t corePoolSize;
-  int32_t maximumPoolSize;
-  Runnable worker;
+  struct ScheduledTimers;
+  std::unique_ptr<ScheduledTimers> timers;
 
-  void workerFunction();
 public:
   virtual ~ScheduledThreadPoolExecutor();
   ScheduledThreadPoolExecutor(int32_t corePoolSize, int32_t maximumPoolSize, ThreadFactory* _threadFactory);
   ScheduledThreadPoolExecutor(int32_t coreSize, ThreadFactory* thf) : ScheduledThreadPoolExecutor(coreSize, coreSize, thf) {}
   ScheduledFuture* scheduleAtFixedRate(std::function<void(void)> methodToRun, ::mariadb::Timer::Clock::duration scheduleDelay,
-    ::mariadb::Timer::Clock::duration delay2);
+    ::mariadb::Timer::Clock::duration period);
 
-  bool prestartCoreThread();
   virtual void shutdown();
-  template <class T, class P>
-  bool awaitTermination(std::chrono::duration<T, P> period);
-  void execute(std::function<void()>);
-  void execute(Runnable code);
   //bool isShutdown()
 };
 }
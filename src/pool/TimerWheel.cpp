@@ -0,0 +1,306 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+#include <map>
+
+#include "TimerWheel.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  const TimerWheel::Clock::duration TimerWheel::TICK= std::chrono::milliseconds(10);
+
+  TimerWheel::Timer::Timer(std::function<void()> _task) :
+    task(_task)
+  {
+  }
+
+
+  TimerWheel::Timer::~Timer()
+  {
+    if (wheel != nullptr) {
+      wheel->cancel(*this);
+    }
+  }
+
+
+  bool TimerWheel::Timer::isArmed() const
+  {
+    return armed.load();
+  }
+
+
+  TimerWheel::TimerWheel() :
+    epoch(Clock::now()),
+    threadFactory("MariaDb-timer-wheel"),
+    worker(std::bind(&TimerWheel::workerFunction, this))
+  {
+    for (auto& level : wheel) {
+      level.fill(nullptr);
+    }
+  }
+
+
+  TimerWheel::~TimerWheel()
+  {
+    {
+      std::lock_guard<std::mutex> localScopeLock(wheelLock);
+      quit= true;
+    }
+    wakeUp.notify_one();
+    if (workerThread.joinable()) {
+      workerThread.join();
+    }
+  }
+
+  /**
+   * Returns process-wide timer wheel. Its thread is started with the first scheduled timer.
+   */
+  TimerWheel& TimerWheel::getInstance()
+  {
+    // Never destructed, since timers may be owned by static objects, e.g. pools, and destructed after it
+    static TimerWheel* instance= new TimerWheel();
+    return *instance;
+  }
+
+
+  /**
+   * Returns process-wide executor for blocking work of the given kind, e.g. network I/O handed over by timer tasks.
+   * Executor is created by the first call with the name, and its threads exit, while there is no work.
+   *
+   * @param name name of the executor's threads
+   * @param threads number of threads, used when the executor is created
+   * @return executor
+   */
+  WorkStealingExecutor& TimerWheel::getBackgroundExecutor(const SQLString& name, int32_t threads)
+  {
+    // Never destructed, same as the wheel, since tasks may be handed over till static objects are destructed
+    static std::mutex* registryLock= new std::mutex();
+    static std::map<SQLString, WorkStealingExecutor*>* registry= new std::map<SQLString, WorkStealingExecutor*>();
+
+    std::lock_guard<std::mutex> localScopeLock(*registryLock);
+    WorkStealingExecutor*& executor= (*registry)[name];
+    if (executor == nullptr) {
+      executor= new WorkStealingExecutor(threads, threads, new MariaDbThreadFactory(name));
+      executor->allowCoreThreadTimeOut(true);
+    }
+    return *executor;
+  }
+
+
+  uint64_t TimerWheel::toTick(Clock::time_point timePoint) const
+  {
+    return static_cast<uint64_t>((timePoint - epoch) / TICK);
+  }
+
+  /**
+   * Arms the timer. If the timer is already armed, it is re-armed with new delay.
+   *
+   * @param timer timer to arm
+   * @param delay time after which the task of the timer is run
+   * @param period if not zero, the task is run repeatedly with this period
+   */
+  void TimerWheel::schedule(Timer& timer, Clock::duration delay, Clock::duration period)
+  {
+    std::unique_lock<std::mutex> localScopeLock(wheelLock);
+
+    if (timer.armed) {
+      unlink(timer);
+    }
+    else {
+      if (armedCount == 0 && running == nullptr) {
+        // Wheel has been idle - no need to go through all passed ticks
+        currentTick= toTick(Clock::now());
+      }
+      ++armedCount;
+    }
+    // Rounding up, so the task never runs earlier than requested
+    uint64_t delayTicks= static_cast<uint64_t>((delay + TICK - Clock::duration(1)) / TICK);
+    timer.deadline= toTick(Clock::now()) + (delayTicks > 0 ? delayTicks : 1);
+    timer.period= static_cast<uint64_t>(period / TICK);
+    if (period > Clock::duration::zero() && timer.period == 0) {
+      timer.period= 1;
+    }
+    timer.wheel= this;
+    timer.canceled= false;
+    timer.armed= true;
+    add(timer);
+
+    if (!workerThread.joinable()) {
+      workerThread= threadFactory.newThread(worker);
+    }
+    localScopeLock.unlock();
+    wakeUp.notify_one();
+  }
+
+  /**
+   * Disarms the timer. If its task is running at the moment, waits till it finishes, unless called from the task
+   * itself.
+   *
+   * @param timer timer to disarm
+   * @return true if the timer has been disarmed before its task has been run
+   */
+  bool TimerWheel::cancel(Timer& timer)
+  {
+    std::unique_lock<std::mutex> localScopeLock(wheelLock);
+
+    if (timer.armed) {
+      unlink(timer);
+      timer.armed= false;
+      --armedCount;
+      return true;
+    }
+    if (running == &timer) {
+      timer.canceled= true;
+      if (std::this_thread::get_id() != workerThread.get_id()) {
+        taskDone.wait(localScopeLock, [&timer, this]() { return running != &timer; });
+      }
+    }
+    return false;
+  }
+
+  /* Puts the timer to the slot according to its deadline. Lock must be held by the caller */
+  void TimerWheel::add(Timer& timer)
+  {
+    uint64_t delta= timer.deadline > currentTick ? timer.deadline - currentTick : 0;
+    uint32_t level= 0;
+
+    // Can be 0 only while cascading - the timer goes to the slot, that is about to be processed
+    timer.expires= currentTick + delta;
+    while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS*(level + 1)))) {
+      ++level;
+    }
+    if (level == LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS*LEVELS))) {
+      // Longer than the wheel covers - parked in the top level slot, that cascades last, and re-added from there
+      // until the deadline is close enough
+      timer.expires= currentTick + (uint64_t(1) << (SLOT_BITS*LEVELS)) - 1;
+    }
+    Timer*& head= wheel[level][(timer.expires >> (SLOT_BITS*level)) & SLOT_MASK];
+
+    timer.prev= nullptr;
+    timer.next= head;
+    if (head != nullptr) {
+      head->prev= &timer;
+    }
+    head= &timer;
+  }
+
+  /* Removes the timer from its slot. Lock must be held by the caller */
+  void TimerWheel::unlink(Timer& timer)
+  {
+    if (timer.prev != nullptr) {
+      timer.prev->next= timer.next;
+    }
+    else {
+      for (auto& level : wheel) {
+        Timer*& head= level[(timer.expires >> (SLOT_BITS*(&level - &wheel[0]))) & SLOT_MASK];
+        if (head == &timer) {
+          head= timer.next;
+          break;
+        }
+      }
+    }
+    if (timer.next != nullptr) {
+      timer.next->prev= timer.prev;
+    }
+    timer.prev= timer.next= nullptr;
+  }
+
+  /* Moves all timers of the current slot of the given level to lower levels */
+  void TimerWheel::cascade(uint32_t level)
+  {
+    Timer*& head= wheel[level][(currentTick >> (SLOT_BITS*level)) & SLOT_MASK];
+    Timer* timer= head;
+
+    head= nullptr;
+    while (timer != nullptr) {
+      Timer* next= timer->next;
+      add(*timer);
+      timer= next;
+    }
+  }
+
+  /* Finds the tick worker has to wake up at. Lock must be held by the caller */
+  uint64_t TimerWheel::nextWakeUpTick()
+  {
+    // Nearest non-empty slot of the lowest level, or the moment the lowest level turns over and upper levels cascade
+    uint64_t tick= currentTick + 1;
+    for (; (tick & SLOT_MASK) != 0; ++tick) {
+      if (wheel[0][tick & SLOT_MASK] != nullptr) {
+        return tick;
+      }
+    }
+    return tick;
+  }
+
+
+  void TimerWheel::workerFunction()
+  {
+    std::unique_lock<std::mutex> localScopeLock(wheelLock);
+
+    while (!quit) {
+      if (armedCount == 0) {
+        wakeUp.wait(localScopeLock);
+        continue;
+      }
+
+      uint64_t nowTick= toTick(Clock::now());
+
+      while (currentTick < nowTick && !quit) {
+        ++currentTick;
+
+        for (uint32_t level= 1; level < LEVELS && (currentTick & ((uint64_t(1) << (SLOT_BITS*level)) - 1)) == 0; ++level) {
+          cascade(level);
+        }
+
+        Timer*& head= wheel[0][currentTick & SLOT_MASK];
+        while (head != nullptr) {
+          Timer& timer= *head;
+
+          unlink(timer);
+          timer.armed= false;
+          --armedCount;
+          running= &timer;
+          localScopeLock.unlock();
+          try {
+            timer.task();
+          }
+          catch (...) {
+            // Task has to handle own errors
+          }
+          localScopeLock.lock();
+          running= nullptr;
+
+          if (timer.period > 0 && !timer.canceled && !timer.armed) {
+            timer.deadline= currentTick + timer.period;
+            timer.armed= true;
+            ++armedCount;
+            add(timer);
+          }
+          taskDone.notify_all();
+        }
+      }
+      if (armedCount > 0 && !quit) {
+        wakeUp.wait_until(localScopeLock, epoch + TICK*nextWakeUpTick());
+      }
+    }
+  }
+}
+}
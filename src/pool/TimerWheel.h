@@ -0,0 +1,116 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+#ifndef _TIMERWHEEL_H_
+#define _TIMERWHEEL_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "ThreadPoolExecutor.h"
+
+namespace sql
+{
+namespace mariadb
+{
+/**
+ * Hierarchical timer wheel, served by a single thread. Timers are intrusive objects owned by the caller, thus arming
+ * and cancelling of a timer is O(1) and does not allocate memory. Task of the timer runs in the wheel's thread, and
+ * should be short. Anything that may block, e.g. network communication, has to be handed over to an executor, e.g.
+ * one of getBackgroundExecutor().
+ */
+class TimerWheel
+{
+public:
+  using Clock= std::chrono::steady_clock;
+
+  class Timer
+  {
+    friend class TimerWheel;
+
+    Timer(const Timer&)= delete;
+    void operator=(const Timer&)= delete;
+
+    std::function<void()> task;
+    TimerWheel* wheel= nullptr;
+    Timer* prev= nullptr;
+    Timer* next= nullptr;
+    /* Tick the task has to run at */
+    uint64_t deadline= 0;
+    /* Tick defining the slot the timer is in. Differs from deadline, if that is beyond the range of the wheel */
+    uint64_t expires= 0;
+    uint64_t period= 0;
+    /* Written under the wheel's lock, read by isArmed() without it */
+    std::atomic<bool> armed{false};
+    bool canceled= false;
+
+  public:
+    Timer(std::function<void()> task);
+    ~Timer();
+    bool isArmed() const;
+  };
+
+  static const Clock::duration TICK;
+
+private:
+  static const uint32_t SLOT_BITS= 6;
+  static const uint32_t SLOTS= 1 << SLOT_BITS;
+  static const uint32_t SLOT_MASK= SLOTS - 1;
+  static const uint32_t LEVELS= 4;
+
+  TimerWheel(const TimerWheel&)= delete;
+  void operator=(const TimerWheel&)= delete;
+
+  std::array<std::array<Timer*, SLOTS>, LEVELS> wheel;
+  const Clock::time_point epoch;
+  uint64_t currentTick= 0;
+  std::size_t armedCount= 0;
+  Timer* running= nullptr;
+  bool quit= false;
+  std::mutex wheelLock;
+  std::condition_variable wakeUp;
+  std::condition_variable taskDone;
+  MariaDbThreadFactory threadFactory;
+  Runnable worker;
+  std::thread workerThread;
+
+  TimerWheel();
+  uint64_t toTick(Clock::time_point timePoint) const;
+  void add(Timer& timer);
+  void unlink(Timer& timer);
+  void cascade(uint32_t level);
+  uint64_t nextWakeUpTick();
+  void workerFunction();
+
+public:
+  ~TimerWheel();
+  static TimerWheel& getInstance();
+  static WorkStealingExecutor& getBackgroundExecutor(const SQLString& name, int32_t threads);
+  void schedule(Timer& timer, Clock::duration delay, Clock::duration period= Clock::duration::zero());
+  bool cancel(Timer& timer);
+};
+
+}
+}
+#endif
@@ -0,0 +1,165 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+#include <vector>
+
+#include "ControlConnections.h"
+#include "MasterProtocol.h"
+#include "UrlParser.h"
+#include "options/Options.h"
+#include "pool/GlobalStateInfo.h"
+#include "util/LogQueryTool.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  const std::chrono::seconds ControlConnections::IDLE_TIMEOUT(60);
+
+  ControlConnections::ControlConnections() :
+    // Closing sends COM_QUIT, thus it is done in own thread, and not in the timer wheel's one
+    idleTimer([this]() {
+      TimerWheel::getBackgroundExecutor("MariaDb-control-connection-closer", 1).execute(std::bind(&ControlConnections::closeIdle, this));
+    })
+  {
+  }
+
+  /* Never destructed - connections may be still in use by other threads when statics are destroyed */
+  ControlConnections& ControlConnections::getInstance()
+  {
+    static ControlConnections* instance= new ControlConnections();
+    return *instance;
+  }
+
+
+  std::shared_ptr<ControlConnections::ControlConnection> ControlConnections::getControlConnection(const SQLString& key)
+  {
+    std::lock_guard<std::mutex> localScopeLock(connectionsLock);
+    auto& control= connections[key];
+    if (!control) {
+      control.reset(new ControlConnection());
+      control->lastUsed= std::chrono::steady_clock::now();
+    }
+    if (!idleTimer.isArmed()) {
+      TimerWheel::getInstance().schedule(idleTimer, IDLE_TIMEOUT / 2, IDLE_TIMEOUT / 2);
+    }
+    return control;
+  }
+
+
+  void ControlConnections::connect(ControlConnection& control, Shared::UrlParser& urlParser, const HostAddress& hostAddress)
+  {
+    control.protocol.reset(new MasterProtocol(urlParser, new GlobalStateInfo()));
+    control.protocol->setHostAddress(hostAddress);
+    try {
+      control.protocol->connect();
+    }
+    catch (SQLException&) {
+      control.protocol.reset();
+      throw;
+    }
+  }
+
+  /**
+   * Kills the query or the connection with given id on the given server. Existing control connection is used, if it
+   * is still alive.
+   *
+   * @param urlParser connection parameters
+   * @param hostAddress server host
+   * @param username user of the connection to kill. Control connection has to be of the same user
+   * @param threadId id of the connection to kill
+   * @param queryOnly true to kill only current query, false to kill the connection
+   * @throws SQLException if the command could not be executed
+   */
+  void ControlConnections::kill(Shared::UrlParser& urlParser, const HostAddress& hostAddress, const SQLString& username,
+    int64_t threadId, bool queryOnly)
+  {
+    // Connections of different DataSources may differ in password, TLS settings and other options
+    SQLString key(username);
+    key.append("@").append(hostAddress.host).append(":").append(std::to_string(hostAddress.port));
+    key.append("/").append(urlParser->getInitialUrl()).append("#").append(std::to_string(urlParser->getOptions()->hashCode()));
+
+    std::shared_ptr<ControlConnection> control(getControlConnection(key));
+    std::lock_guard<std::mutex> localScopeLock(control->lock);
+    control->lastUsed= std::chrono::steady_clock::now();
+    SQLString command(queryOnly ? "KILL QUERY " : "KILL ");
+    command.append(std::to_string(threadId));
+
+    bool reused= true;
+    if (!control->protocol || control->protocol->isClosed()) {
+      connect(*control, urlParser, hostAddress);
+      reused= false;
+    }
+
+    try {
+      control->protocol->executeQuery(command);
+    }
+    catch (SQLException& e) {
+      // Idle control connection may have been closed by the server in the meantime - trying once more with the new one
+      if (!reused ||
+        (e.getErrorCode() != 2006 && e.getErrorCode() != 2013 && !e.getSQLState().startsWith("08"))) {
+        throw;
+      }
+      control->protocol.reset();
+      connect(*control, urlParser, hostAddress);
+      control->protocol->executeQuery(command);
+    }
+  }
+
+  /**
+   * Closes connections not used for IDLE_TIMEOUT. Connections, that are busy at the moment, are skipped. The idle
+   * timer is stopped when no connection is left. Connections are closed after the map lock is released.
+   */
+  void ControlConnections::closeIdle()
+  {
+    std::vector<std::shared_ptr<ControlConnection>> idle;
+    {
+      std::lock_guard<std::mutex> localScopeLock(connectionsLock);
+      auto now= std::chrono::steady_clock::now();
+
+      for (auto it= connections.begin(); it != connections.end();) {
+        std::unique_lock<std::mutex> controlLock(it->second->lock, std::try_to_lock);
+        if (controlLock.owns_lock() && now - it->second->lastUsed >= IDLE_TIMEOUT) {
+          controlLock.unlock();
+          idle.push_back(it->second);
+          it= connections.erase(it);
+        }
+        else {
+          ++it;
+        }
+      }
+      if (connections.empty()) {
+        TimerWheel::getInstance().cancel(idleTimer);
+      }
+    }
+  }
+
+  /* Closes all control connections. Called when the driver's pools are closed */
+  void ControlConnections::clear()
+  {
+    std::map<SQLString, std::shared_ptr<ControlConnection>> closing;
+    {
+      std::lock_guard<std::mutex> localScopeLock(connectionsLock);
+      closing.swap(connections);
+      TimerWheel::getInstance().cancel(idleTimer);
+    }
+  }
+}
+}
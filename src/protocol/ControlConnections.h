@@ -0,0 +1,76 @@
+/************************************************************************************
+   Copyright (C) 2026 MariaDB Corporation plc
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+#ifndef _CONTROLCONNECTIONS_H_
+#define _CONTROLCONNECTIONS_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <chrono>
+
+#include "Consts.h"
+#include "HostAddress.h"
+#include "pool/TimerWheel.h"
+
+namespace sql
+{
+namespace mariadb
+{
+class MasterProtocol;
+
+/**
+ * Connections used to send KILL [QUERY] commands, one per server host, user and set of connection options. Connection
+ * is created on the first use, re-created if it has been lost, and closed after IDLE_TIMEOUT without use. Commands for
+ * the same host are serialized, thus cancellation of many queries at once costs one round trip each, and does not open
+ * new connections to the server.
+ */
+class ControlConnections
+{
+  struct ControlConnection
+  {
+    std::mutex lock;
+    std::unique_ptr<MasterProtocol> protocol;
+    std::chrono::steady_clock::time_point lastUsed;
+  };
+
+  static const std::chrono::seconds IDLE_TIMEOUT;
+
+  std::map<SQLString, std::shared_ptr<ControlConnection>> connections;
+  std::mutex connectionsLock;
+  TimerWheel::Timer idleTimer;
+
+  ControlConnections();
+  ControlConnections(const ControlConnections&)= delete;
+  void operator=(const ControlConnections&)= delete;
+
+  std::shared_ptr<ControlConnection> getControlConnection(const SQLString& key);
+  static void connect(ControlConnection& control, Shared::UrlParser& urlParser, const HostAddress& hostAddress);
+  void closeIdle();
+
+public:
+  static ControlConnections& getInstance();
+  void kill(Shared::UrlParser& urlParser, const HostAddress& hostAddress, const SQLString& username,
+    int64_t threadId, bool queryOnly);
+  void clear();
+};
+}
+}
+#endif
@@ -20,6 +20,14 @@
 
 #include <random>
 #include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+
+#ifndef _WIN32
+# include <poll.h>
+# include <cerrno>
+#endif
 
 #include "util/ServerPrepareStatementCache.h"
 
@@ -27,10 +35,15 @@
 
 #include "logger/LoggerFactory.h"
 #include "protocol/MasterProtocol.h"
+#include "protocol/ControlConnections.h"
 #include "Results.h"
 #include "ExceptionFactory.h"
 #include "util/Utils.h"
 #include "util/LogQueryTool.h"
+#include "pool/GlobalStateCache.h"
+#include "failover/HostStateTable.h"
+#include "failover/HostMonitor.h"
+#include "pool/TimerWheel.h"
 
 namespace sql
 {
@@ -45,8 +58,10 @@ namespace capi
   const SQLString ConnectProtocol::SESSION_QUERY("SELECT @@max_allowed_packet,"
     "@@system_time_zone,"
     "@@time_zone,"
-    "@@auto_increment_increment");
+    "@@auto_increment_increment,"
+    "@@wait_timeout");
   const SQLString ConnectProtocol::IS_MASTER_QUERY("select @@innodb_read_only");
+  const SQLString ConnectProtocol::CHECK_GALERA_STATE_QUERY("show status like 'wsrep_local_state'");
   Logger* ConnectProtocol::logger= LoggerFactory::getLogger(typeid(ConnectProtocol));
   static const SQLString MARIADB_RPL_HACK_PREFIX("5.5.5-");
 
@@ -77,11 +92,27 @@ namespace capi
     else {
       serverPrepareStatementCache.reset(new NoCache());
     }
+    if (!options->galeraAllowedState.empty()) {
+      galeraAllowedStates= split(options->galeraAllowedState, ",");
+    }
+  }
+
+
+  ConnectProtocol::~ConnectProtocol()
+  {
+    if (hostConnectionCounted) {
+      HostStateTable::connectionClosed(currentHost);
+    }
   }
 
 
   void ConnectProtocol::closeSocket()
   {
+    standby.reset();
+    if (hostConnectionCounted) {
+      HostStateTable::connectionClosed(currentHost);
+      hostConnectionCounted= false;
+    }
     try {
       connection.reset();
     }catch (std::exception& ){
@@ -303,11 +334,7 @@ namespace capi
   void ConnectProtocol::forceAbort()
   {
     try {
-      std::unique_ptr<MasterProtocol> copiedProtocol(new MasterProtocol(urlParser, new GlobalStateInfo()));
-      copiedProtocol->setHostAddress(getHostAddress());
-      copiedProtocol->connect();
-
-      copiedProtocol->executeQuery("KILL " + std::to_string(serverThreadId));
+      ControlConnections::getInstance().kill(urlParser, getHostAddress(), getUsername(), serverThreadId, false);
     }catch (SQLException& ){
 
     }
@@ -380,7 +407,14 @@ namespace capi
   }
 
 
-  void ConnectProtocol::createConnection(HostAddress* hostAddress, const SQLString& username)
+  /**
+   * Creates and configures connection handle for the host. Does not connect.
+   *
+   * @param hostAddress server address, may be NULL (e.g. pipe)
+   * @param username user name
+   * @throws SQLException if handle could not be configured
+   */
+  void ConnectProtocol::createHandle(HostAddress* hostAddress, const SQLString& username)
   {
 
     SQLString host(hostAddress != nullptr ? hostAddress->host : "");
@@ -452,12 +486,45 @@ namespace capi
     }
     mysql_optionsv(connection.get(), MYSQL_REPORT_DATA_TRUNCATION, &uintOptionSelected);
     mysql_optionsv(connection.get(), MYSQL_OPT_LOCAL_INFILE, (options->allowLocalInfile ? &uintOptionSelected : &uintOptionNotSelected));
+  }
+
+
+  namespace
+  {
+    /* Client errors(2000-2999) mean the server could not be reached. If the server has replied with an error, it is alive */
+    void recordConnectError(const HostAddress& host, uint32_t errNo)
+    {
+      if (errNo >= 2000 && errNo < 3000) {
+        HostStateTable::recordFailure(host);
+      }
+      else {
+        HostStateTable::recordAlive(host);
+      }
+    }
+  }
+
+
+  void ConnectProtocol::createConnection(HostAddress* hostAddress, const SQLString& username)
+  {
+    createHandle(hostAddress, username);
 
+    auto connectStart= std::chrono::steady_clock::now();
     if (mysql_real_connect(connection.get(), NULL, NULL, NULL, NULL, 0, NULL, CLIENT_MULTI_STATEMENTS) == nullptr)
     {
+      if (hostAddress != nullptr) {
+        recordConnectError(*hostAddress, mysql_errno(connection.get()));
+      }
       throw SQLException(mysql_error(connection.get()), mysql_sqlstate(connection.get()), mysql_errno(connection.get()));
     }
+    if (hostAddress != nullptr) {
+      HostStateTable::recordSuccess(*hostAddress, std::chrono::steady_clock::now() - connectStart);
+    }
+    completeConnection();
+  }
 
+  /** Reads connection properties and runs connection initialization queries, once the handle is connected */
+  void ConnectProtocol::completeConnection()
+  {
     connected= true;
 
     this->serverThreadId= mysql_thread_id(connection.get());
@@ -650,6 +717,19 @@ namespace capi
         }
       }
 
+      GlobalStateInfo cachedInfo;
+      SQLString cacheKey;
+
+      if (mustLoadAdditionalInfo && options->staticGlobal){
+        cacheKey= GlobalStateCache::getKey(getUsername(), getHost(), getPort(), options->sessionVariables);
+        if (GlobalStateCache::get(cacheKey, serverVersion, serverCapabilities, options->staticGlobalTtl, cachedInfo)){
+          std::map<SQLString,SQLString> serverData;
+          // Only session settings have to be sent, global values are known
+          additionalData(serverData, false);
+          mustLoadAdditionalInfo= false;
+        }
+      }
+
       if (mustLoadAdditionalInfo){
         std::map<SQLString,SQLString> serverData;
         if (options->usePipelineAuth && !options->createDatabaseIfNotExist){
@@ -672,16 +752,35 @@ namespace capi
         mysql_optionsv(connection.get(), MYSQL_OPT_MAX_ALLOWED_PACKET, &maxAllowedPacket);
         autoIncrementIncrement= std::stoi(StringImp::get(serverData["auto_increment_increment"]));
         loadCalendar(serverData["time_zone"],serverData["system_time_zone"]);
+        try {
+          transactionIsolationLevel= Utils::transactionFromString(serverData[getTxIsolationVariable()]);
+        }
+        catch (SQLException&) {
+          // Will be unknown till explicitly set by application
+          transactionIsolationLevel= 0;
+        }
+
+        if (options->staticGlobal && !serverData["wait_timeout"].empty()){
+          GlobalStateInfo info(maxAllowedPacket, std::stoi(StringImp::get(serverData["wait_timeout"])), options->autocommit,
+            autoIncrementIncrement, serverData["time_zone"], serverData["system_time_zone"], transactionIsolationLevel);
+          GlobalStateCache::put(cacheKey, serverVersion, serverCapabilities, info);
+        }
 
       }else {
-        size_t maxAllowedPacket= static_cast<size_t>(globalInfo->getMaxAllowedPacket());
+        const GlobalStateInfo& info= globalInfo ? *globalInfo : cachedInfo;
+        size_t maxAllowedPacket= static_cast<size_t>(info.getMaxAllowedPacket());
         mysql_optionsv(connection.get(), MYSQL_OPT_MAX_ALLOWED_PACKET, &maxAllowedPacket);
-        autoIncrementIncrement= globalInfo->getAutoIncrementIncrement();
-        loadCalendar(globalInfo->getTimeZone(), globalInfo->getSystemTimeZone());
+        autoIncrementIncrement= info.getAutoIncrementIncrement();
+        loadCalendar(info.getTimeZone(), info.getSystemTimeZone());
+        if (!globalInfo){
+          transactionIsolationLevel= info.getDefaultTransactionIsolation();
+        }
       }
 
       activeStreamingResult= nullptr;
       hostFailed= false;
+      // Without session tracking there is no way to know, what the application changes
+      sessionStateChanged= !sessionStateAware();
     }catch (SQLException& sqlException){
       destroySocket();
       throw sqlException;
@@ -700,22 +799,24 @@ namespace capi
    */
   void ConnectProtocol::sendPipelineAdditionalData()
   {
-    sendSessionInfos();
-    sendRequestSessionVariables();
+    sendQuery(getSessionInfosQuery());
+    sendQuery(getSessionQuery());
 
     sendPipelineCheckMaster();
   }
 
-  void ConnectProtocol::sendSessionInfos()
+  /**
+   * Builds the "set" query for the session variables, that have to be set after connection.
+   *
+   * @return query text
+   */
+  SQLString ConnectProtocol::getSessionInfosQuery()
   {
     SQLString sessionOption("autocommit=");
     sessionOption.append(options->autocommit ? "1" : "0");
 
     if ((serverCapabilities & MariaDbServerCapabilities::CLIENT_SESSION_TRACK)!=0){
-      sessionOption.append(", session_track_schema=1");
-      if (options->rewriteBatchedStatements){
-        sessionOption.append(", session_track_system_variables= 'auto_increment_increment' ");
-      }
+      sessionOption.append(", ").append(getSessionTrackingOptions());
     }
 
     if (options->jdbcCompliantTruncation){
@@ -726,13 +827,106 @@ namespace capi
       sessionOption.append(",").append(Utils::parseSessionVariables(options->sessionVariables));
     }
 
-    SQLString query("set "+sessionOption);
-    realQuery(query);
+    return "set " + sessionOption;
+  }
+
+  /**
+   * Session variables, that server has to report back in OK packets, when they are changed. That allows to keep their
+   * values on the client side, and not to query the server for them.
+   *
+   * @return "session_track_*" variables assignments list
+   */
+  SQLString ConnectProtocol::getSessionTrackingOptions()
+  {
+    SQLString trackingOptions("session_track_schema=1, session_track_state_change=1, "
+      "session_track_system_variables='autocommit,auto_increment_increment,");
+    return trackingOptions.append(getTxIsolationVariable()).append("'");
+  }
+
+  /**
+   * Updates sessionStateChanged after the command, that the server has reported as changing session state. The
+   * driver restores autocommit and current database on its own, any other change(user or session variables,
+   * temporary tables etc) requires COM_RESET_CONNECTION. The state change tracker does not tell what has been
+   * changed, thus if it has fired, or if the server has not reported, what exactly has been changed, the session is
+   * considered changed.
+   */
+  void ConnectProtocol::checkSessionStateChange()
+  {
+    const char *value;
+    size_t len;
+    bool restorable= false;
+
+    if (sessionStateChanged) {
+      return;
+    }
+    if (mysql_session_track_get_first(connection.get(), SESSION_TRACK_STATE_CHANGE, &value, &len) == 0) {
+      sessionStateChanged= true;
+      return;
+    }
+    if (mysql_session_track_get_first(connection.get(), SESSION_TRACK_SCHEMA, &value, &len) == 0) {
+      restorable= true;
+    }
+    // System variables are reported as name/value pairs
+    int32_t rc= mysql_session_track_get_first(connection.get(), SESSION_TRACK_SYSTEM_VARIABLES, &value, &len);
+    while (rc == 0) {
+      if (SQLString(value, len).compare("autocommit") != 0) {
+        sessionStateChanged= true;
+        return;
+      }
+      restorable= true;
+      if (mysql_session_track_get_next(connection.get(), SESSION_TRACK_SYSTEM_VARIABLES, &value, &len) != 0) {
+        break;
+      }
+      rc= mysql_session_track_get_next(connection.get(), SESSION_TRACK_SYSTEM_VARIABLES, &value, &len);
+    }
+    // Nothing is detailed - something not tracked has been changed
+    if (!restorable) {
+      sessionStateChanged= true;
+    }
+  }
+
+
+  bool ConnectProtocol::isSessionStateChanged()
+  {
+    return sessionStateChanged;
+  }
+
+  /**
+   * Lets the driver drop the state change report of the command it has issued itself, and whose effect it restores
+   * on its own, e.g. of autocommit change via API.
+   */
+  void ConnectProtocol::setSessionStateChanged(bool changed)
+  {
+    sessionStateChanged= changed;
+  }
+
+  /**
+   * Name of the server variable containing session transaction isolation level
+   *
+   * @return variable name
+   */
+  const char* ConnectProtocol::getTxIsolationVariable()
+  {
+    if (!isServerMariaDb() && ((getMajorServerVersion() >= 8 && versionGreaterOrEqual(8, 0, 3))
+      || (getMajorServerVersion() < 8 && versionGreaterOrEqual(5, 7, 20)))) {
+      return "transaction_isolation";
+    }
+    return "tx_isolation";
+  }
+
+  SQLString ConnectProtocol::getSessionQuery()
+  {
+    return SESSION_QUERY + ",@@" + getTxIsolationVariable();
+  }
+
+  void ConnectProtocol::sendSessionInfos()
+  {
+    realQuery(getSessionInfosQuery());
   }
 
   void ConnectProtocol::sendRequestSessionVariables()
   {
-    realQuery(SESSION_QUERY);
+    realQuery(getSessionQuery());
   }
 
   void ConnectProtocol::readRequestSessionVariables(std::map<SQLString, SQLString>& serverData)
@@ -750,6 +944,8 @@ namespace capi
       serverData.emplace("system_time_zone",resultSet->getString(2));
       serverData.emplace("time_zone",resultSet->getString(3));
       serverData.emplace("auto_increment_increment", resultSet->getString(4));
+      serverData.emplace("wait_timeout", resultSet->getString(5));
+      serverData.emplace(getTxIsolationVariable(), resultSet->getString(6));
 
     }else {
       throw SQLException(mysql_get_socket(connection.get()) == MARIADB_INVALID_SOCKET ?
@@ -758,18 +954,6 @@ namespace capi
     }
   }
 
-  void ConnectProtocol::sendCreateDatabaseIfNotExist(const SQLString& quotedDb)
-  {
-    SQLString query("CREATE DATABASE IF NOT EXISTS "+ quotedDb);
-    mysql_real_query(connection.get(), query.c_str(), static_cast<unsigned long>(query.length()));
-  }
-
-  void ConnectProtocol::sendUseDatabaseIfNotExist(const SQLString& quotedDb)
-  {
-    SQLString query("USE "+quotedDb);
-    mysql_real_query(connection.get(), query.c_str(), static_cast<unsigned long>(query.length()));
-  }
-
   void ConnectProtocol::readPipelineAdditionalData(std::map<SQLString, SQLString>& serverData)
   {
 
@@ -777,6 +961,7 @@ namespace capi
 
     try {
       Unique::Results res(new Results());
+      readQueryResult();
       getResult(res.get());
     }catch (SQLException& sqlException){
 
@@ -786,6 +971,7 @@ namespace capi
     bool canTrySessionWithShow= false;
 
     try {
+      readQueryResult();
       readRequestSessionVariables(serverData);
     }catch (SQLException& sqlException){
       if (!resultingException){
@@ -829,7 +1015,9 @@ namespace capi
           "'max_allowed_packet',"
           "'system_time_zone',"
           "'time_zone',"
-          "'auto_increment_increment')");
+          "'auto_increment_increment',"
+          "'wait_timeout',"
+          "'" + SQLString(getTxIsolationVariable()) + "')");
       results->commandEnd();
       ResultSet* resultSet= results->getResultSet();
       if (resultSet){
@@ -851,34 +1039,82 @@ namespace capi
   }
 
 
-  void ConnectProtocol::additionalData(std::map<SQLString, SQLString>& serverData)
+  /**
+   * Sends all connection initialization queries as one multi-statement, i.e. in one round trip, and reads their results.
+   * If session variables could not be read with the query, falls back to SHOW VARIABLES.
+   *
+   * @param serverData [out] session variables values
+   * @param loadSessionVariables if session variables values have to be read
+   */
+  void ConnectProtocol::additionalData(std::map<SQLString, SQLString>& serverData, bool loadSessionVariables)
   {
     Unique::Results res(new Results());
-    sendSessionInfos();
+    SQLString query(getSessionInfosQuery());
+    bool createDatabase= options->createDatabaseIfNotExist && !database.empty();
+
+    if (createDatabase){
+      SQLString quotedDb(MariaDbConnection::quoteIdentifier(this->database));
+      query.append(";CREATE DATABASE IF NOT EXISTS ").append(quotedDb).append(";USE ").append(quotedDb);
+    }
+    if (loadSessionVariables){
+      query.append(";").append(getSessionQuery());
+    }
+
+    realQuery(query);
     getResult(res.get());
 
-    try {
-      sendRequestSessionVariables();
-      readRequestSessionVariables(serverData);
-    }catch (SQLException& ){
-      requestSessionDataWithShow(serverData);
+    if (createDatabase){
+      for (int32_t i= 0; i < 2; ++i){
+        // Errors will be thrown by getResult
+        capi::mysql_next_result(connection.get());
+        res.reset(new Results());
+        getResult(res.get());
+      }
+    }
+
+    if (loadSessionVariables){
+      try {
+        if (!hasMoreResults() || capi::mysql_next_result(connection.get()) != 0){
+          throw SQLException("Error reading SessionVariables results");
+        }
+        readRequestSessionVariables(serverData);
+      }catch (SQLException& ){
+        requestSessionDataWithShow(serverData);
+      }
     }
 
     sendPipelineCheckMaster();
     readPipelineCheckMaster();
+  }
 
-    if (options->createDatabaseIfNotExist && !database.empty()){
-
-      SQLString quotedDb(MariaDbConnection::quoteIdentifier(this->database));
-      sendCreateDatabaseIfNotExist(quotedDb);
+  /**
+   * Checks if Galera node state "wsrep_local_state" is one of allowed by galeraAllowedState option.
+   *
+   * @return true if the state is allowed
+   * @throws SQLException if the state could not be read
+   */
+  bool ConnectProtocol::checkGaleraState()
+  {
+    Results results;
+    executeQuery(true, &results, CHECK_GALERA_STATE_QUERY);
+    results.commandEnd();
+    ResultSet* rs= results.getResultSet();
 
-      Unique::Results res(new Results());
-      getResult(res.get());
+    if (rs && rs->next())
+    {
+      SQLString statusVal(rs->getString(2));
+      auto cit= galeraAllowedStates->cbegin();
 
-      sendUseDatabaseIfNotExist(quotedDb);
-      res.reset(new Results());
-      getResult(res.get());
+      for (; cit != galeraAllowedStates->end(); ++cit)
+      {
+        if (cit->compare(statusVal) == 0)
+        {
+          break;
+        }
+      }
+      return (cit != galeraAllowedStates->end());
     }
+    return false;
   }
 
   /**
@@ -996,6 +1232,10 @@ namespace capi
   uint32_t ConnectProtocol::getServerStatus()
   {
     mariadb_get_infov(connection.get(), MARIADB_CONNECTION_SERVER_STATUS, (void*)&this->serverStatus);
+    // This is how result sets report end of data, and state change, if the query has done any
+    if ((serverStatus & ServerStatus::SERVER_SESSION_STATE_CHANGED_) != 0) {
+      checkSessionStateChange();
+    }
     return serverStatus;
   }
 
@@ -1063,18 +1303,47 @@ namespace capi
    * @throws SQLException exception
    */
   void ConnectProtocol::connectWithoutProxy()
+  {
+    connectToHosts(urlParser->getHostAddresses(), urlParser->getHaMode() == HaMode::LOADBALANCE);
+  }
+
+  /**
+   * Connects to one of given hosts.
+   *
+   * @param addrs hosts to connect to, in the order of priority
+   * @param balanceLoad if true, host is chosen by its load score, and Galera node state is checked if requested
+   * @throws SQLException if could not connect to any host
+   */
+  void ConnectProtocol::connectToHosts(const std::vector<HostAddress>& addrs, bool balanceLoad)
   {
     if (!isClosed()){
       close();
     }
 
-    std::vector<HostAddress>& addrs= urlParser->getHostAddresses();
     std::vector<HostAddress> hosts(addrs);
 
-    if (urlParser->getHaMode() == HaMode::LOADBALANCE) {
+    if (balanceLoad) {
+      // Hosts with the same score are tried in random order
       static auto rnd= std::default_random_engine{};
       std::shuffle(hosts.begin(), hosts.end(), rnd);
+
+      std::vector<std::pair<int64_t, HostAddress>> scored;
+      for (auto& host : hosts) {
+        scored.emplace_back(HostStateTable::getLoadScore(host), host);
+      }
+      std::stable_sort(scored.begin(), scored.end(),
+        [](const std::pair<int64_t, HostAddress>& first, const std::pair<int64_t, HostAddress>& second) {
+          return first.first < second.first;
+        });
+      hosts.clear();
+      for (auto& it : scored) {
+        hosts.push_back(it.second);
+      }
     }
+    // Hosts known to be unavailable are tried last. The order of others is kept
+    std::stable_partition(hosts.begin(), hosts.end(), [this](const HostAddress& host) {
+      return !HostStateTable::isBlacklisted(host, options->loadBalanceBlacklistTimeout);
+    });
 
     if (hosts.empty() && !options->pipe.empty()){
       try {
@@ -1092,29 +1361,343 @@ namespace capi
       }
     }
 
-    while (!hosts.empty()){
-      currentHost= hosts.back();
-      hosts.pop_back();
+    while (true) {
+      try {
+        connectToAnyHost(hosts);
+      }catch (SQLException& e){
+        if (!e.getSQLState().empty()){
+          ExceptionFactory::INSTANCE.create(
+              "Could not connect to "
+              + HostAddress::toString(addrs)
+              + " : "
+              + e.getMessage()
+              + getTraces(),
+              e.getSQLState(),
+              e.getErrorCode(),
+              &e).Throw();
+        }
+        ExceptionFactory::INSTANCE.create(
+            "Could not connect to " + currentHost.toString() +". "+e.getMessage()+getTraces(), "08000", &e).Throw();
+      }
+
+      // In LOADBALANCE mode, Galera node that is not in allowed state(e.g. donor) is not used
+      if (!balanceLoad || !galeraAllowedStates || galeraAllowedStates->empty() ||
+        checkGaleraState()) {
+        break;
+      }
+      HostStateTable::recordFailure(currentHost);
+      close();
+      for (auto it= hosts.begin(); it != hosts.end(); ++it) {
+        if (it->host.compare(currentHost.host) == 0 && it->port == currentHost.port) {
+          hosts.erase(it);
+          break;
+        }
+      }
+      if (hosts.empty()) {
+        ExceptionFactory::INSTANCE.create(
+          "Could not connect to " + HostAddress::toString(addrs) + " : no host is in allowed Galera state '"
+          + options->galeraAllowedState + "'", "08000").Throw();
+      }
+    }
+    HostStateTable::connectionOpened(currentHost);
+
+    if (options->hostMonitorInterval > 0 && addrs.size() > 1 && !hostMonitor) {
+      hostMonitor= HostMonitor::getMonitor(urlParser, addrs);
+    }
+    hostConnectionCounted= true;
+
+    if (options->warmStandby && addrs.size() > 1) {
+      standbyHosts= addrs;
+      openStandby();
+    }
+  }
+
+
+  struct ConnectProtocol::Standby
+  {
+    std::mutex lock;
+    std::unique_ptr<MasterProtocol> protocol;
+  };
+
+  /**
+   * Opens spare connection in the background to the most preferred host except the current one. If the current host
+   * is listed more than once, other occurrences may be used.
+   */
+  void ConnectProtocol::openStandby()
+  {
+    std::vector<HostAddress> candidates(standbyHosts);
+
+    for (auto it= candidates.begin(); it != candidates.end(); ++it) {
+      if (it->host.compare(currentHost.host) == 0 && it->port == currentHost.port) {
+        candidates.erase(it);
+        break;
+      }
+    }
+    std::stable_partition(candidates.begin(), candidates.end(), [this](const HostAddress& host) {
+      return !HostStateTable::isBlacklisted(host, options->loadBalanceBlacklistTimeout);
+    });
+    if (candidates.empty()) {
+      return;
+    }
+
+    standby.reset(new Standby());
+    std::shared_ptr<Standby> holder(standby);
+    std::shared_ptr<UrlParser> parser(urlParser);
+
+    // The task owns all it uses, and the spare connection is released with the holder
+    TimerWheel::getBackgroundExecutor("MariaDb-standby-connect", 2).execute([holder, parser, candidates]() mutable {
+      std::unique_ptr<MasterProtocol> spare(new MasterProtocol(parser, new GlobalStateInfo()));
+
+      for (auto& host : candidates) {
+        spare->setHostAddress(host);
+        try {
+          spare->connect();
+          std::lock_guard<std::mutex> standbyLock(holder->lock);
+          holder->protocol= std::move(spare);
+          return;
+        }
+        catch (SQLException&) {
+        }
+      }
+    });
+  }
+
+  /**
+   * Moves server connection and its properties between two protocol objects. Session state is not moved.
+   */
+  void ConnectProtocol::swapConnection(ConnectProtocol& other)
+  {
+    bool otherConnected= other.connected;
+
+    std::swap(connection, other.connection);
+    std::swap(currentHost, other.currentHost);
+    std::swap(hostConnectionCounted, other.hostConnectionCounted);
+    std::swap(serverThreadId, other.serverThreadId);
+    std::swap(serverVersion, other.serverVersion);
+    std::swap(serverMariaDb, other.serverMariaDb);
+    std::swap(majorVersion, other.majorVersion);
+    std::swap(minorVersion, other.minorVersion);
+    std::swap(patchVersion, other.patchVersion);
+    std::swap(serverCapabilities, other.serverCapabilities);
+    std::swap(eofDeprecated, other.eofDeprecated);
+    std::swap(serverStatus, other.serverStatus);
+    std::swap(autoIncrementIncrement, other.autoIncrementIncrement);
+    std::swap(sessionStateChanged, other.sessionStateChanged);
+    other.connected= connected;
+    connected= otherConnected;
+  }
+
+  /**
+   * Switches to the spare connection, if it is ready and alive. The session state is then restored with one
+   * multi-statement query, and new spare connection is opened.
+   *
+   * @return true if switched to the spare connection
+   */
+  bool ConnectProtocol::failoverToStandby()
+  {
+    std::unique_ptr<MasterProtocol> spare;
+    {
+      std::lock_guard<std::mutex> standbyLock(standby->lock);
+      spare= std::move(standby->protocol);
+    }
+    bool alive= false;
+    try {
+      alive= spare && spare->ping();
+    }
+    catch (SQLException&) {
+    }
+    if (!alive) {
+      return false;
+    }
+
+    int64_t maxRows= getMaxRows();
+    int32_t isolationLevel= transactionIsolationLevel;
+    SQLString currentDatabase(database);
+    bool autocommit= getAutocommit();
+
+    swapConnection(*spare);
+    // Now it holds the lost connection
+    spare.reset();
+    HostStateTable::connectionOpened(currentHost);
+    hostConnectionCounted= true;
+
+    resetStateAfterFailover(maxRows, isolationLevel, currentDatabase, autocommit);
+    openStandby();
+
+    return true;
+  }
+
+  /**
+   * Connects to the first available host of the list, either in parallel, or trying hosts one by one.
+   *
+   * @param hosts hosts in the order of preference
+   * @throws SQLException error of the last attempt, if could connect to none of hosts
+   */
+  void ConnectProtocol::connectToAnyHost(std::vector<HostAddress>& hosts)
+  {
+    if (hosts.size() > 1 && options->parallelConnectDelay > 0) {
+      connectParallel(hosts);
+      return;
+    }
+
+    for (auto it= hosts.begin(); it != hosts.end(); ++it) {
+      currentHost= *it;
       try {
         createConnection(&currentHost, username);
         return;
-      }catch (SQLException& e){
-        if (hosts.empty()){
-          if (!e.getSQLState().empty()){
-            ExceptionFactory::INSTANCE.create(
-                "Could not connect to "
-                + HostAddress::toString(addrs)
-                + " : "
-                + e.getMessage()
-                + getTraces(),
-                e.getSQLState(),
-                e.getErrorCode(),
-                &e).Throw();
+      }catch (SQLException&){
+        if (it + 1 == hosts.end()){
+          throw;
+        }
+      }
+    }
+  }
+
+  namespace
+  {
+    /* State of the parallel connection attempts shared between the connecting thread and attempt threads */
+    struct ConnectRace
+    {
+      std::mutex lock;
+      std::condition_variable attemptDone;
+      std::vector<MYSQL*> handles;
+      std::size_t failed= 0;
+      /* Indexes of connected handles, that have not been tried yet, in order of their connection */
+      std::deque<std::size_t> connected;
+      /* Set, once the connecting thread does not need more handles */
+      bool decided= false;
+      SQLString lastError;
+      SQLString lastSqlState;
+      uint32_t lastErrno= 0;
+
+      ConnectRace(std::size_t size) : handles(size, nullptr) {}
+
+      void setError(const SQLString& error, const SQLString& sqlState, uint32_t errNo)
+      {
+        lastError= error;
+        lastSqlState= sqlState;
+        lastErrno= errNo;
+      }
+    };
+
+    /* Attempts of concurrent connects share the executor. If all threads are busy, attempts wait in its queue */
+    const int32_t PARALLEL_CONNECT_THREADS= 32;
+
+    void connectAttempt(std::shared_ptr<ConnectRace> race, std::size_t index, HostAddress host)
+    {
+      MYSQL* handle= race->handles[index];
+      auto connectStart= std::chrono::steady_clock::now();
+      bool success= mysql_real_connect(handle, NULL, NULL, NULL, NULL, 0, NULL, CLIENT_MULTI_STATEMENTS) != nullptr;
+
+      if (success) {
+        HostStateTable::recordSuccess(host, std::chrono::steady_clock::now() - connectStart);
+      }
+      else {
+        recordConnectError(host, mysql_errno(handle));
+      }
+
+      std::unique_lock<std::mutex> raceLock(race->lock);
+      if (success && !race->decided) {
+        race->connected.push_back(index);
+      }
+      else {
+        if (!success) {
+          ++race->failed;
+          race->setError(mysql_error(handle), mysql_sqlstate(handle), mysql_errno(handle));
+        }
+        race->handles[index]= nullptr;
+        raceLock.unlock();
+        mysql_close(handle);
+        raceLock.lock();
+      }
+      race->attemptDone.notify_all();
+    }
+  }
+
+  /**
+   * Connects to the first host that completes the handshake. Attempts are started in the hosts order, the next one
+   * is started after parallelConnectDelay, or right away if all started attempts have failed. If the connection
+   * initialization fails on the connected handle, the next connected one is tried, or more attempts are started.
+   * Attempts run on a shared background executor. Handles of attempts that lost the race are closed by their tasks,
+   * or by this thread, if they have connected before it is done.
+   *
+   * @param hosts hosts in the order of preference
+   * @throws SQLException if could connect to none of hosts
+   */
+  void ConnectProtocol::connectParallel(std::vector<HostAddress>& hosts)
+  {
+    std::shared_ptr<ConnectRace> race(new ConnectRace(hosts.size()));
+    const std::chrono::milliseconds delay(options->parallelConnectDelay);
+    std::size_t started= 0;
+    std::unique_lock<std::mutex> raceLock(race->lock);
+
+    auto canProceed= [&]() {
+      return !race->connected.empty() || race->failed == started;
+    };
+
+    while (true) {
+      while (race->connected.empty() && race->failed < hosts.size()) {
+        if (started == hosts.size()) {
+          race->attemptDone.wait(raceLock, canProceed);
+          continue;
+        }
+        if (started > 0 && !canProceed()) {
+          race->attemptDone.wait_for(raceLock, delay, canProceed);
+          if (!race->connected.empty()) {
+            break;
           }
-          ExceptionFactory::INSTANCE.create(
-              "Could not connect to " + currentHost.toString() +". "+e.getMessage()+getTraces(), "08000", &e).Throw();
         }
+        try {
+          createHandle(&hosts[started], username);
+          race->handles[started]= connection.release();
+          std::size_t index= started;
+          HostAddress host(hosts[started]);
+          // Attempt owns the race state, thus outlives this call if it loses. Idle threads of the executor retire
+          TimerWheel::getBackgroundExecutor("MariaDb-parallel-connect", PARALLEL_CONNECT_THREADS).execute(
+            [race, index, host]() { connectAttempt(race, index, host); });
+        }
+        catch (SQLException& e) {
+          ++race->failed;
+          race->setError(e.getMessage(), e.getSQLState(), e.getErrorCode());
+        }
+        ++started;
+      }
+
+      if (race->connected.empty()) {
+        race->decided= true;
+        throw SQLException(race->lastError, race->lastSqlState, race->lastErrno);
       }
+      std::size_t winner= race->connected.front();
+      race->connected.pop_front();
+      connection.reset(race->handles[winner]);
+      race->handles[winner]= nullptr;
+      currentHost= hosts[winner];
+      raceLock.unlock();
+
+      try {
+        completeConnection();
+        break;
+      }
+      catch (SQLException& e) {
+        connection.reset();
+        connected= false;
+        raceLock.lock();
+        ++race->failed;
+        race->setError(e.getMessage(), e.getSQLState(), e.getErrorCode());
+      }
+    }
+
+    std::vector<MYSQL*> spare;
+    raceLock.lock();
+    race->decided= true;
+    for (std::size_t index : race->connected) {
+      spare.push_back(race->handles[index]);
+      race->handles[index]= nullptr;
+    }
+    race->connected.clear();
+    raceLock.unlock();
+    for (MYSQL* handle : spare) {
+      mysql_close(handle);
     }
   }
 
@@ -1307,6 +1890,43 @@ namespace capi
     return mysql_get_socket(Dbc->mariadb) == MARIADB_INVALID_SOCKET;
   }*/
 
+  /**
+   * Checks without sending anything to the server, if the connection has been closed by the server, or is broken.
+   * Idle connection should have nothing to read - end of stream, socket error or any data(e.g. the error packet
+   * server sends, when wait_timeout expires) all mean, that the connection is not usable.
+   *
+   * @return true if the socket has been found closed or broken, false if nothing has been found, or if the
+   *         connection is not over a socket
+   */
+  bool ConnectProtocol::isSocketClosed()
+  {
+    if (!connected || !connection) {
+      return true;
+    }
+    my_socket fd= mysql_get_socket(connection.get());
+
+    if (fd == MARIADB_INVALID_SOCKET) {
+      return false;
+    }
+#ifdef _WIN32
+    fd_set readSet;
+    struct timeval noWait= {0, 0};
+
+    FD_ZERO(&readSet);
+    FD_SET(fd, &readSet);
+    return select(0, &readSet, nullptr, nullptr, &noWait) != 0;
+#else
+    struct pollfd pfd;
+
+    pfd.fd= fd;
+    pfd.events= POLLIN;
+    pfd.revents= 0;
+    int rc= poll(&pfd, 1, 0);
+    return rc > 0 || (rc < 0 && errno != EINTR);
+#endif
+  }
+
+
   bool ConnectProtocol::isExplicitClosed()
   {
     return explicitClosed;
@@ -1434,10 +2054,40 @@ namespace capi
     }
   }
 
+  /**
+   * Sends query to the server without reading the result. Used for pipelining.
+   *
+   * @param sql - query to send
+   */
+  void ConnectProtocol::sendQuery(const SQLString& sql)
+  {
+    if (capi::mysql_send_query(connection.get(), sql.c_str(), static_cast<unsigned long>(sql.length()))) {
+      throw SQLException(capi::mysql_error(connection.get()), capi::mysql_sqlstate(connection.get()),
+                        capi::mysql_errno(connection.get()));
+    }
+  }
+
+  /**
+   * Reads the response of the query sent with sendQuery. Errors are not thrown here, since they are handled
+   * by subsequent getResult call.
+   */
+  void ConnectProtocol::readQueryResult()
+  {
+    capi::mysql_read_query_result(connection.get());
+  }
+
   void ConnectProtocol::reconnect()
   {
+    // Server could be restarted with different settings
+    if (options->staticGlobal) {
+      GlobalStateCache::invalidate(GlobalStateCache::getKey(getUsername(), getHost(), getPort(), options->sessionVariables));
+    }
+
     std::lock_guard<std::mutex> localScopeLock(lock);
 
+    if (standby && failoverToStandby()) {
+      return;
+    }
     if (!options->autoReconnect)
     {
       mysql_optionsv(connection.get(), MYSQL_OPT_RECONNECT, &OptionSelected);
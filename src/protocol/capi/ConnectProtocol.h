@@ -40,6 +40,7 @@ namespace mariadb
   class Socket;
   class SSLSocket;
   class Credential;
+  class HostMonitor;
 
 namespace capi
 {
@@ -51,7 +52,8 @@ namespace capi
     static const SQLString SESSION_QUERY; /*("SELECT @@max_allowed_packet,"
     +"@@system_time_zone,"
     +"@@time_zone,"
-    +"@@auto_increment_increment")*/
+    +"@@auto_increment_increment,"
+    +"@@wait_timeout")*/
     static const SQLString IS_MASTER_QUERY; /*"SELECT @@innodb_read_only"*/
     static Logger* logger;
 
@@ -61,7 +63,9 @@ namespace capi
     std::shared_ptr<UrlParser> urlParser;
     Shared::Options options;
     Shared::ExceptionFactory exceptionFactory;
-    virtual ~ConnectProtocol() {}
+    static const SQLString CHECK_GALERA_STATE_QUERY; /*"show status like 'wsrep_local_state'"*/
+    Tokens galeraAllowedStates;
+    virtual ~ConnectProtocol();
 
   private:
     const SQLString username;
@@ -76,6 +80,8 @@ namespace capi
 
   protected:
     int32_t autoIncrementIncrement;
+    /* 0 if not known */
+    int32_t transactionIsolationLevel= 0;
 
     bool readOnly= false;
     FailoverProxy* proxy= nullptr;
@@ -87,9 +93,19 @@ namespace capi
     bool eofDeprecated= false;
     int64_t serverCapabilities= 0;
     int32_t socketTimeout= 0;
+    /* If session state has been changed in a way, that only COM_RESET_CONNECTION can restore */
+    bool sessionStateChanged= true;
 
   private:
     HostAddress currentHost;
+    /* If the connection is counted in HostStateTable as open to the currentHost */
+    bool hostConnectionCounted= false;
+    /* Health check of the hosts, shared with other connections to the same hosts */
+    std::shared_ptr<HostMonitor> hostMonitor;
+    /* Spare connection to the next host, that reconnect switches to(warmStandby option) */
+    struct Standby;
+    std::shared_ptr<Standby> standby;
+    std::vector<HostAddress> standbyHosts;
     bool hostFailed= false;
     SQLString serverVersion;
     bool serverMariaDb= true;
@@ -110,6 +126,8 @@ namespace capi
 
   protected:
     void realQuery(const SQLString& sql);
+    void sendQuery(const SQLString& sql);
+    void readQueryResult();
   public:
     void close();
     void abort();
@@ -133,6 +151,13 @@ namespace capi
   private:
     /* hostAddress may be NULL (e.g. pipe)*/
     void createConnection(HostAddress* hostAddress, const SQLString& username);
+    void createHandle(HostAddress* hostAddress, const SQLString& username);
+    void completeConnection();
+    void connectParallel(std::vector<HostAddress>& hosts);
+    void connectToAnyHost(std::vector<HostAddress>& hosts);
+    void openStandby();
+    bool failoverToStandby();
+    void swapConnection(ConnectProtocol& other);
 
   public:
     void destroySocket();
@@ -158,17 +183,23 @@ namespace capi
     void assignStream(const Shared::Options& options);
     void postConnectionQueries();
     void sendPipelineAdditionalData();
+    SQLString getSessionInfosQuery();
+    SQLString getSessionQuery();
     void sendSessionInfos();
     void sendRequestSessionVariables();
     void readRequestSessionVariables(std::map<SQLString, SQLString>& serverData);
-    void sendCreateDatabaseIfNotExist(const SQLString& quotedDb);
-    void sendUseDatabaseIfNotExist(const SQLString& quotedDb);
     void readPipelineAdditionalData(std::map<SQLString, SQLString>& serverData);
     void requestSessionDataWithShow(std::map<SQLString, SQLString>& serverData);
-    void additionalData(std::map<SQLString, SQLString>& serverData);
+    void additionalData(std::map<SQLString, SQLString>& serverData, bool loadSessionVariables= true);
+
+  protected:
+    SQLString getSessionTrackingOptions();
+    const char* getTxIsolationVariable();
+    void checkSessionStateChange();
 
   public:
     bool isClosed();
+    bool isSocketClosed();
 
   private:
     void loadCalendar(const SQLString& srvTimeZone, const SQLString& srvSystemTimeZone);
@@ -193,7 +224,9 @@ namespace capi
     void readPipelineCheckMaster();
     bool mustBeMasterConnection();
     bool noBackslashEscapes();
+    bool checkGaleraState();
     void connectWithoutProxy();
+    void connectToHosts(const std::vector<HostAddress>& addrs, bool balanceLoad);
     bool shouldReconnectWithoutProxy();
     const SQLString& getServerVersion() const;
     bool getReadonly() const;
@@ -238,6 +271,8 @@ namespace capi
     PacketOutputStream* getWriter();*/
     bool isEofDeprecated();
     bool sessionStateAware();
+    bool isSessionStateChanged();
+    void setSessionStateChanged(bool changed);
     SQLString getTraces();
     void reconnect();
   };
@@ -30,6 +30,8 @@
 #include "util/StateChange.h"
 #include "util/Utils.h"
 #include "protocol/MasterProtocol.h"
+#include "protocol/ControlConnections.h"
+#include "failover/HostStateTable.h"
 #include "SqlStates.h"
 #include "com/capi/ColumnDefinitionCapi.h"
 #include "ExceptionFactory.h"
@@ -48,7 +50,6 @@ namespace capi
   static const int64_t MAX_PACKET_LENGTH= 0x00ffffff + 4;
 
   Logger* QueryProtocol::logger= LoggerFactory::getLogger(typeid(QueryProtocol));
-  const SQLString QueryProtocol::CHECK_GALERA_STATE_QUERY("show status like 'wsrep_local_state'");
 
   void throwStmtError(MYSQL_STMT* stmt) {
     SQLString err(mysql_stmt_error(stmt)), sqlState(mysql_stmt_sqlstate(stmt));
@@ -67,22 +68,32 @@ namespace capi
     : super(urlParser, globalInfo)
     , logQuery(new LogQueryTool(options))
   {
-    if (!urlParser->getOptions()->galeraAllowedState.empty())
-    {
-      galeraAllowedStates= split(urlParser->getOptions()->galeraAllowedState, ",");
-    }
   }
 
   void QueryProtocol::reset()
   {
     cmdPrologue();
     try {
+      std::vector<std::string> cacheKeys(serverPrepareStatementCache->keys());
 
       if (mysql_reset_connection(connection.get()))
       {
         throw SQLException("Connection reset failed");
       }
       serverPrepareStatementCache->clear();
+      // Nothing has been prepared since the previous reset - keys recorded then are still to be re-prepared
+      if (!cacheKeys.empty()) {
+        rePrepareKeys.swap(cacheKeys);
+      }
+
+      // Reset sets session variables to their global values - cached values are not valid anymore, and the tracking
+      // has to be turned on again
+      transactionIsolationLevel= 0;
+      autoIncrementIncrement= 0;
+      if (sessionStateAware()) {
+        realQuery("SET " + getSessionTrackingOptions());
+      }
+      sessionStateChanged= !sessionStateAware();
 
     } catch (SQLException& sqlException) {
       throw logQuery->exceptionWithQuery("COM_RESET_CONNECTION failed.", sqlException, explicitClosed);
@@ -91,6 +102,45 @@ namespace capi
     }
   }
 
+  /**
+   * Prepares again statements, that were in the cache before reset has closed them on the server. That is done on
+   * the first prepare after the reset, i.e. only if the connection is used with prepared statements again, and at most
+   * MAX_REPREPARED most recently used of them, since Connector/C cannot pipeline COM_STMT_PREPARE. Only statements
+   * prepared in the current database can be restored.
+   *
+   * @param preparedKey cache key of the statement, that has been just prepared
+   */
+  void QueryProtocol::rePrepare(const std::string& preparedKey)
+  {
+    static const std::size_t MAX_REPREPARED= 8;
+    const std::string prefix(StringImp::get(getDatabase()) + "-");
+    std::vector<std::string> cacheKeys;
+
+    cacheKeys.swap(rePrepareKeys);
+    if (cacheKeys.size() > MAX_REPREPARED) {
+      cacheKeys.resize(MAX_REPREPARED);
+    }
+    // Least recently used go first to restore the same order in the cache
+    for (auto it= cacheKeys.rbegin(); it != cacheKeys.rend(); ++it) {
+      if (it->compare(0, prefix.length(), prefix) != 0 || it->compare(preparedKey) == 0) {
+        continue;
+      }
+      try {
+        ServerPrepareResult* pr= prepareInternal(it->substr(prefix.length()), true);
+        // Only the cache keeps the reference
+        if (pr->canBeDeallocate()) {
+          delete pr;
+        }
+        else {
+          pr->decrementShareCounter();
+        }
+      }
+      catch (SQLException&) {
+        // The statement will be prepared again, when needed
+      }
+    }
+  }
+
   /**
    * Execute internal query.
    *
@@ -563,6 +613,7 @@ namespace capi
       MariaDBExceptionThrower exception;
 
       for (auto& sql : queries) {
+        stopIfInterrupted();
         try {
           realQuery(sql);
           getResult(results);
@@ -597,6 +648,8 @@ namespace capi
     {
       realQuery(query);
       getResult(results);
+      // Timeout timer does not kill batch queries, but the rest of the batch should not be sent
+      stopIfInterrupted();
     }
   }
 
@@ -653,7 +706,11 @@ namespace capi
     cmdPrologue();
     std::unique_ptr<std::lock_guard<std::mutex>> localScopeLock;
 
-    return prepareInternal(sql, executeOnMaster);
+    ServerPrepareResult* pr= prepareInternal(sql, executeOnMaster);
+    if (!rePrepareKeys.empty()) {
+      rePrepare(StringImp::get(getDatabase() + "-" + sql));
+    }
+    return pr;
   }
 
 
@@ -1089,8 +1146,13 @@ namespace capi
     cmdPrologue();
     std::lock_guard<std::mutex> localScopeLock(lock);
     try {
+      auto pingStart= std::chrono::steady_clock::now();
 
-      return mysql_ping(connection.get()) == 0;
+      if (mysql_ping(connection.get()) != 0) {
+        return false;
+      }
+      HostStateTable::recordQueryLatency(getHostAddress(), std::chrono::steady_clock::now() - pingStart);
+      return true;
 
     }catch (std::runtime_error& e){
       connected= false;
@@ -1109,27 +1171,7 @@ namespace capi
         this->changeSocketSoTimeout(timeout);
       }
       if (isMasterConnection() && galeraAllowedStates && galeraAllowedStates->size() != 0) {
-
-        Results results;
-        executeQuery(true, &results, CHECK_GALERA_STATE_QUERY);
-        results.commandEnd();
-        ResultSet* rs= results.getResultSet();
-
-        if (rs && rs->next())
-        {
-          SQLString statusVal(rs->getString(2));
-          auto cit= galeraAllowedStates->cbegin();
-
-          for (; cit != galeraAllowedStates->end(); ++cit)
-          {
-            if (cit->compare(statusVal) == 0)
-            {
-              break;
-            }
-          }
-          return (cit != galeraAllowedStates->end());
-        }
-        return false;
+        return checkGaleraState();
       }
 
       return ping();
@@ -1211,12 +1253,7 @@ namespace capi
 
   void QueryProtocol::cancelCurrentQuery()
   {
-    std::unique_ptr<MasterProtocol> copiedProtocol(new MasterProtocol(urlParser, new GlobalStateInfo()));
-
-    copiedProtocol->setHostAddress(getHostAddress());
-    copiedProtocol->connect();
-
-    copiedProtocol->executeQuery("KILL QUERY " + std::to_string(serverThreadId));
+    ControlConnections::getInstance().kill(urlParser, getHostAddress(), getUsername(), serverThreadId, true);
 
     interrupted= true;
   }
@@ -1308,27 +1345,28 @@ namespace capi
     cmdPrologue();
     std::lock_guard<std::mutex> localScopeLock(lock);
 
-    SQLString query= "SET SESSION TRANSACTION ISOLATION LEVEL";
+    SQLString query= "SET SESSION TRANSACTION ISOLATION LEVEL ";
+    query.append(getIsolationLevelName(level));
 
+    realQuery(query);
+    transactionIsolationLevel= level;
+  }
+
+
+  const char* QueryProtocol::getIsolationLevelName(int32_t level)
+  {
     switch (level){
       case sql::TRANSACTION_READ_UNCOMMITTED:
-        query.append(" READ UNCOMMITTED");
-        break;
+        return "READ UNCOMMITTED";
       case sql::TRANSACTION_READ_COMMITTED:
-        query.append(" READ COMMITTED");
-        break;
+        return "READ COMMITTED";
       case sql::TRANSACTION_REPEATABLE_READ:
-        query.append(" REPEATABLE READ");
-        break;
+        return "REPEATABLE READ";
       case sql::TRANSACTION_SERIALIZABLE:
-        query.append(" SERIALIZABLE");
-        break;
+        return "SERIALIZABLE";
       default:
         throw SQLException("Unsupported transaction isolation level");
     }
-
-    realQuery(query);
-    transactionIsolationLevel= level;
   }
 
 
@@ -1429,31 +1467,54 @@ namespace capi
     const char *value;
     size_t len;
 
-    for (int32_t type=SESSION_TRACK_BEGIN; type < SESSION_TRACK_END; ++type)
+    checkSessionStateChange();
+
+    // System variables are reported as name/value pairs
+    int32_t rc= mysql_session_track_get_first(connection.get(), capi::SESSION_TRACK_SYSTEM_VARIABLES, &value, &len);
+    while (rc == 0)
     {
-      if (mysql_session_track_get_first(connection.get(), static_cast<enum capi::enum_session_state_type>(type), &value, &len) == 0)
-      {
-        std::string str(value, len);
+      SQLString name(value, len);
 
-        switch (type) {
-        case StateChange::SESSION_TRACK_SYSTEM_VARIABLES:
-          if (str.compare("auto_increment_increment") == 0)
-          {
-            autoIncrementIncrement= std::stoi(str);
-            results->setAutoIncrement(autoIncrementIncrement);
-          }
-          break;
+      if (mysql_session_track_get_next(connection.get(), capi::SESSION_TRACK_SYSTEM_VARIABLES, &value, &len) != 0) {
+        break;
+      }
+      updateSessionVariable(name, SQLString(value, len), results);
+      rc= mysql_session_track_get_next(connection.get(), capi::SESSION_TRACK_SYSTEM_VARIABLES, &value, &len);
+    }
 
-        case StateChange::SESSION_TRACK_SCHEMA:
-          database= str;
-          logger->debug("Database change : now is '" + database + "'");
-          break;
+    if (mysql_session_track_get_first(connection.get(), capi::SESSION_TRACK_SCHEMA, &value, &len) == 0)
+    {
+      database= SQLString(value, len);
+      logger->debug("Database change : now is '" + database + "'");
+    }
+  }
 
-        default:
-          break;
-        }
+  /**
+   * Updates client side copy of the session variable reported by the server in session state change information
+   *
+   * @param name variable name
+   * @param value new value
+   * @param results current results object
+   */
+  void QueryProtocol::updateSessionVariable(const SQLString& name, const SQLString& value, Results* results)
+  {
+    if (name.compare("auto_increment_increment") == 0)
+    {
+      autoIncrementIncrement= std::stoi(StringImp::get(value));
+      if (results != nullptr) {
+        results->setAutoIncrement(autoIncrementIncrement);
+      }
+    }
+    else if (name.compare("tx_isolation") == 0 || name.compare("transaction_isolation") == 0)
+    {
+      try {
+        transactionIsolationLevel= Utils::transactionFromString(value);
+      }
+      catch (SQLException&) {
+        transactionIsolationLevel= 0;
       }
     }
+    // autocommit is tracked to have state change reported, its value is kept in the serverStatus
   }
 
 
@@ -1783,19 +1844,29 @@ namespace capi
   void QueryProtocol::resetStateAfterFailover(
       int64_t maxRows,int32_t transactionIsolationLevel, const SQLString& database,bool autocommit)
   {
-    setMaxRows(maxRows);
+    // All state is restored with one multi-statement query
+    SQLString query("SET autocommit=");
+    query.append(autocommit ? "1" : "0");
 
-    if (transactionIsolationLevel != 0){
-      setTransactionIsolation(transactionIsolationLevel);
+    // The connection may have been used with a limit before(e.g. warm standby), thus the limit is always set
+    query.append(",SQL_SELECT_LIMIT=").append(maxRows != 0 ? std::to_string(maxRows) : "DEFAULT");
+    if (transactionIsolationLevel != 0) {
+      query.append(";SET SESSION TRANSACTION ISOLATION LEVEL ").append(getIsolationLevelName(transactionIsolationLevel));
     }
-
-    if (!database.empty() && !(getDatabase().compare(database) == 0)){
-      setCatalog(database);
+    if (!database.empty()) {
+      query.append(";USE `").append(replace(database, "`", "``")).append("`");
     }
 
-    if (getAutocommit()!=autocommit){
-      executeQuery(SQLString("set autocommit=").append(autocommit ?"1":"0"));
+    Results results;
+    executeQuery(true, &results, query);
+    while (hasMoreResults()) {
+      moveToNextResult(&results, nullptr);
+      getResult(&results);
     }
+
+    this->maxRows= maxRows;
+    this->transactionIsolationLevel= transactionIsolationLevel;
+    this->database= database;
   }
 
   /**
@@ -22,6 +22,7 @@
 #define _ABSTRACTQUERYPROTOCOL_H_
 
 #include <istream>
+#include <atomic>
 #include <vector>
 
 #include "Consts.h"
@@ -44,11 +45,8 @@ namespace capi
     typedef capi::ConnectProtocol super;
 
     static Logger* logger;
-    static const SQLString CHECK_GALERA_STATE_QUERY; /*"show status like 'wsrep_local_state'"*/
     std::unique_ptr<LogQueryTool> logQuery;
-    Tokens galeraAllowedStates;
     //ThreadPoolExecutor readScheduler; /*NULL*/
-    int32_t transactionIsolationLevel= 0;
 #ifdef WE_DO_OWN_PROTOCOL_IMPEMENTATION
     std::unique_ptr<std::istream> localInfileInputStream;
 #endif
@@ -56,7 +54,9 @@ namespace capi
     /*volatile*/
     MYSQL_STMT* statementIdToRelease= nullptr;
     FutureTask* activeFutureTask= nullptr;
-    bool interrupted= false;
+    std::atomic<bool> interrupted{false};
+    /* Keys of statements, that were in the cache before the last reset, most recently used first */
+    std::vector<std::string> rePrepareKeys;
 
   protected:
     QueryProtocol(std::shared_ptr<UrlParser>& urlParser, GlobalStateInfo* globalInfo);
@@ -165,7 +165,9 @@ namespace capi
     int32_t getTransactionIsolationLevel();
 
   private:
+    static const char* getIsolationLevelName(int32_t level);
     void checkClose();
+    void rePrepare(const std::string& preparedKey);
 
   public:
     void moveToNextResult(Results* results, ServerPrepareResult* spr);
@@ -175,6 +177,7 @@ namespace capi
     void readPacket(Results* results, ServerPrepareResult *pr);
     void readOkPacket(Results* results, ServerPrepareResult *pr);
     void handleStateChange(Results* results);
+    void updateSessionVariable(const SQLString& name, const SQLString& value, Results* results);
     uint32_t errorOccurred(ServerPrepareResult *pr);
     uint32_t fieldCount(ServerPrepareResult *pr);
 
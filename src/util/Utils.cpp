@@ -26,6 +26,7 @@
 #include "LogQueryTool.h"
 #include "logger/ProtocolLoggingProxy.h"
 #include "protocol/MasterProtocol.h"
+#include "failover/MastersReplicasProtocol.h"
 
 
 namespace sql
@@ -513,15 +514,12 @@ namespace mariadb
               new FailoverProxy(new AuroraListener(urlParser,globalInfo))));
 #endif
       case REPLICATION:
-#ifdef REPLICATION_SUPPORT_IMPLEMENTED
-        return getProxyLoggingIfNeeded(
-            urlParser,
-            (Protocol&)
-            Proxy.newProxyInstance(
-              MastersSlavesProtocol.class.getClassLoader(),
-              new Class[] {Protocol&.class},
-              new FailoverProxy(new MastersSlavesListener(urlParser,globalInfo))));
-#endif
+      {
+        Shared::Protocol protocol(getProxyLoggingIfNeeded(urlParser, new MastersReplicasProtocol(urlParser, globalInfo)));
+        protocol->connectWithoutProxy();
+
+        return protocol;
+      }
       case LOADBALANCE:
 #ifdef LOADBALANCE_SUPPORT_IMPLEMENTED
         return getProxyLoggingIfNeeded(
@@ -531,10 +529,8 @@ namespace mariadb
               MasterProtocol.class.getClassLoader(),
               new Class[] {Protocol&.class},
               new FailoverProxy(new MastersFailoverListener(urlParser,globalInfo))));
-#else
-        /* This exception supposed to be already thrown*/
-        throw SQLFeatureNotImplementedException(SQLString("Support of the HA mode") + HaModeStrMap[urlParser->getHaMode()] + "is not yet implemented");
 #endif
+      /* Load is balanced on connection level - connectWithoutProxy chooses the host for the new connection */
       case SEQUENTIAL:
       default:
         Shared::Protocol protocol(getProxyLoggingIfNeeded(urlParser, new MasterProtocol(urlParser, globalInfo)));
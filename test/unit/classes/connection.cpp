@@ -3372,6 +3372,23 @@ void connection::concpp94_loadLocalInfile()
 }
 
 
+/* Splits the test url into the host part and the rest(path and parameters), so tests can build multi-host urls */
+static void splitUrl(const sql::SQLString& url, sql::SQLString& host, sql::SQLString& rest)
+{
+  std::size_t doubleSlash= url.find("//"), slash;
+
+  if (doubleSlash == std::string::npos) {
+    slash= url.find_first_of('/');
+    host= url.substr(0, slash);
+  }
+  else {
+    slash= url.find_first_of('/', doubleSlash + 2);
+    host= url.substr(doubleSlash + 2, slash - doubleSlash - 2);
+  }
+  rest= url.substr(slash);
+}
+
+
 void connection::concpp4_sequentialfailover()
 {
   const sql::SQLString dummyHost("240.0.0.1:3307"), sequentialPrefix("jdbc:mariadb:sequential://"), hostsSeparator(",");
@@ -3532,6 +3549,331 @@ void connection::concpp112_connection_attributes()
   con.reset();
 }
 
+
+void connection::pipelineAuth()
+{
+  sql::Properties p{{"user", user}, {"password", passwd}, {"useTls", useTls ? "true" : "false"},
+    {"sessionVariables", "auto_increment_increment=3"}};
+
+  for (auto pipeline : {"true", "false"})
+  {
+    p["usePipelineAuth"]= pipeline;
+    con.reset(driver->connect(url, p));
+    ASSERT(con.get());
+    stmt.reset(con->createStatement());
+    res.reset(stmt->executeQuery("SELECT @@auto_increment_increment, @@autocommit"));
+    ASSERT(res->next());
+    ASSERT_EQUALS(3, res->getInt(1));
+    ASSERT_EQUALS(1, res->getInt(2));
+    // Connection has to be usable after all results of initialization queries have been read
+    ASSERT(con->isValid(1));
+  }
+  stmt.reset(con->createStatement());
+  res.reset();
+}
+
+
+void connection::sessionStateTracking()
+{
+  if (std::getenv("srv") != nullptr && strcmp(std::getenv("srv"), "mysql") == 0) {
+    SKIP("Skipping test for mysql since doesn't use tx_isolation");
+  }
+  stmt.reset(con->createStatement());
+  stmt->execute("SET SESSION TRANSACTION ISOLATION LEVEL READ COMMITTED");
+  ASSERT_EQUALS(sql::TRANSACTION_READ_COMMITTED, con->getTransactionIsolation());
+  stmt->execute("SET SESSION tx_isolation='SERIALIZABLE'");
+  ASSERT_EQUALS(sql::TRANSACTION_SERIALIZABLE, con->getTransactionIsolation());
+
+  stmt->execute("USE mysql");
+  ASSERT_EQUALS("mysql", con->getSchema());
+  stmt->execute("USE " + db);
+  ASSERT_EQUALS(db, con->getSchema());
+
+  // Tracking has to work after the connection reset as well
+  con->reset();
+  stmt.reset(con->createStatement());
+  stmt->execute("SET SESSION TRANSACTION ISOLATION LEVEL READ UNCOMMITTED");
+  ASSERT_EQUALS(sql::TRANSACTION_READ_UNCOMMITTED, con->getTransactionIsolation());
+}
+
+
+void connection::staticGlobal()
+{
+  if (std::getenv("srv") != nullptr && strcmp(std::getenv("srv"), "mysql") == 0) {
+    SKIP("Skipping test for mysql since doesn't use tx_isolation");
+  }
+  // sessionVariables value no other test uses, so the cache entry is created by this test
+  sql::Properties p{{"user", user}, {"password", passwd}, {"useTls", useTls ? "true" : "false"}, {"staticGlobal", "true"},
+    {"sessionVariables", "auto_increment_offset=1"}};
+  int64_t selects[2];
+
+  // 1st connection fills the cache, 2nd uses it
+  for (int32_t i= 0; i < 2; ++i)
+  {
+    con.reset(driver->connect(url, p));
+    stmt.reset(con->createStatement());
+    // SELECTs run by the connection initialization
+    res.reset(stmt->executeQuery("SHOW SESSION STATUS LIKE 'Com_select'"));
+    ASSERT(res->next());
+    selects[i]= res->getInt64(2);
+    res.reset(stmt->executeQuery("SELECT @@tx_isolation"));
+    ASSERT(res->next());
+    switch (con->getTransactionIsolation())
+    {
+    case sql::TRANSACTION_READ_UNCOMMITTED:
+      ASSERT_EQUALS("READ-UNCOMMITTED", res->getString(1));
+      break;
+    case sql::TRANSACTION_READ_COMMITTED:
+      ASSERT_EQUALS("READ-COMMITTED", res->getString(1));
+      break;
+    case sql::TRANSACTION_REPEATABLE_READ:
+      ASSERT_EQUALS("REPEATABLE-READ", res->getString(1));
+      break;
+    case sql::TRANSACTION_SERIALIZABLE:
+      ASSERT_EQUALS("SERIALIZABLE", res->getString(1));
+      break;
+    default:
+      FAIL("Unexpected transaction isolation level");
+    }
+  }
+  // Connection using the cache does not read the global variables
+  ASSERT(selects[1] < selects[0]);
+
+  // Session variables are part of the cache key
+  p["sessionVariables"]= "auto_increment_increment=2";
+  con.reset(driver->connect(url, p));
+  stmt.reset(con->createStatement());
+  res.reset(stmt->executeQuery("SELECT @@auto_increment_increment"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(2, res->getInt(1));
+}
+
+void connection::parallelConnect()
+{
+  // Not the same dummy host as in concpp4_sequentialfailover, it must not be known as failed yet
+  const sql::SQLString dummyHost("240.0.0.2:3307"), sequentialPrefix("jdbc:mariadb:sequential://"), hostsSeparator(",");
+  sql::SQLString localUrl(sequentialPrefix + dummyHost + hostsSeparator), realHost, theRest;
+
+  splitUrl(url, realHost, theRest);
+  localUrl.append(realHost).append(theRest);
+
+  sql::Properties p{{"connectTimeout", "3000"}, {"user", user}, {"password", passwd}, {"useTls", useTls ? "true" : "false"},
+                    {"parallelConnectDelay", "250"}};
+
+  // Attempt to the real host is started while the dummy one still hangs
+  auto start= std::chrono::steady_clock::now();
+  con.reset(driver->connect(localUrl, p));
+  ASSERT(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(2000));
+
+  // Sequential attempts have to wait for the dummy host, until it's known as failed
+  p["parallelConnectDelay"]= "0";
+  std::this_thread::sleep_for(std::chrono::milliseconds(3500));
+  start= std::chrono::steady_clock::now();
+  con.reset(driver->connect(localUrl, p));
+  ASSERT(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(2000));
+  stmt.reset(con->createStatement());
+  res.reset(stmt->executeQuery("SELECT 1"));
+  ASSERT(res->next());
+}
+
+
+void connection::loadBalance()
+{
+  const sql::SQLString dummyHost("240.0.0.3:3307"), loadBalancePrefix("jdbc:mariadb:loadbalance://"), hostsSeparator(",");
+  sql::SQLString localUrl(loadBalancePrefix + dummyHost + hostsSeparator), realHost, theRest;
+
+  splitUrl(url, realHost, theRest);
+  localUrl.append(realHost).append(theRest);
+
+  sql::Properties p{{"connectTimeout", "3000"}, {"user", user}, {"password", passwd}, {"useTls", useTls ? "true" : "false"}};
+
+  for (int32_t i= 0; i < 3; ++i) {
+    con.reset(driver->connect(localUrl, p));
+    stmt.reset(con->createStatement());
+    res.reset(stmt->executeQuery("SELECT 1"));
+    ASSERT(res->next());
+  }
+
+  res.reset(stmt->executeQuery("SHOW STATUS LIKE 'wsrep_local_state'"));
+  if (res->next()) {
+    SKIP("Server is a Galera node");
+  }
+  // Server, that is not Galera node, can't be in any allowed state
+  p["galeraAllowedState"]= "4";
+  try
+  {
+    con.reset(driver->connect(localUrl, p));
+    FAIL("Connection to the host not in allowed Galera state should fail");
+  }
+  catch (sql::SQLException &)
+  {
+  }
+}
+
+
+/* REPLICATION mode. The test server plays both master and replica - read-only queries have to go via another connection */
+void connection::replication()
+{
+  const sql::SQLString replicationPrefix("jdbc:mariadb:replication://"), hostsSeparator(",");
+  sql::SQLString localUrl(replicationPrefix), realHost, theRest;
+
+  splitUrl(url, realHost, theRest);
+  localUrl.append(realHost).append(hostsSeparator).append(realHost).append(theRest);
+
+  sql::Properties p{{"user", user}, {"password", passwd}, {"useTls", useTls ? "true" : "false"}};
+
+  con.reset(driver->connect(localUrl, p));
+  stmt.reset(con->createStatement());
+  res.reset(stmt->executeQuery("SELECT CONNECTION_ID(), DATABASE()"));
+  ASSERT(res->next());
+  int64_t masterId= res->getLong(1);
+  sql::SQLString masterDb(res->getString(2));
+
+  con->setReadOnly(true);
+  ASSERT(con->isReadOnly());
+  res.reset(stmt->executeQuery("SELECT CONNECTION_ID(), DATABASE()"));
+  ASSERT(res->next());
+  ASSERT(masterId != res->getLong(1));
+  ASSERT_EQUALS(masterDb, res->getString(2));
+
+  con->setReadOnly(false);
+  res.reset(stmt->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(masterId, res->getLong(1));
+
+  // Switching in the middle of a transaction is not allowed
+  con->setAutoCommit(false);
+  stmt->execute("START TRANSACTION");
+  try
+  {
+    con->setReadOnly(true);
+    FAIL("Read-only mode should not be changed while transaction is in progress");
+  }
+  catch (sql::SQLException &)
+  {
+  }
+  con->commit();
+  con->setReadOnly(true);
+  res.reset(stmt->executeQuery("SELECT @@autocommit"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(0, res->getInt(1));
+  con->commit();
+}
+
+
+/* Connections to the same hosts share one health monitor, that keeps own connection to every live host */
+void connection::hostMonitor()
+{
+  const sql::SQLString dummyHost("240.0.0.4:3307"), sequentialPrefix("jdbc:mariadb:sequential://"), hostsSeparator(",");
+  sql::SQLString localUrl(sequentialPrefix + dummyHost + hostsSeparator), realHost, theRest;
+  const sql::SQLString countQuery("SELECT COUNT(*) FROM information_schema.processlist WHERE USER=SUBSTRING_INDEX(USER(), '@', 1)");
+
+  splitUrl(url, realHost, theRest);
+  localUrl.append(realHost).append(theRest);
+
+  sql::Properties p{{"connectTimeout", "1000"}, {"user", user}, {"password", passwd}, {"useTls", useTls ? "true" : "false"},
+    {"hostMonitorInterval", "100"}};
+
+  res.reset(stmt->executeQuery(countQuery));
+  ASSERT(res->next());
+  int32_t initialCount= res->getInt(1);
+
+  std::unique_ptr<sql::Connection> con1(driver->connect(localUrl, p));
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  res.reset(stmt->executeQuery(countQuery));
+  ASSERT(res->next());
+  ASSERT_EQUALS(initialCount + 2, res->getInt(1));
+
+  std::unique_ptr<sql::Connection> con2(driver->connect(localUrl, p));
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  res.reset(stmt->executeQuery(countQuery));
+  ASSERT(res->next());
+  ASSERT_EQUALS(initialCount + 3, res->getInt(1));
+
+  // Monitor stops with the last connection
+  con1->close();
+  con2->close();
+  con1.reset();
+  con2.reset();
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  res.reset(stmt->executeQuery(countQuery));
+  ASSERT(res->next());
+  ASSERT_EQUALS(initialCount, res->getInt(1));
+}
+
+
+/* Reconnect switches to the spare connection, and session state is restored there */
+void connection::warmStandby()
+{
+  const sql::SQLString sequentialPrefix("jdbc:mariadb:sequential://"), hostsSeparator(",");
+  sql::SQLString localUrl(sequentialPrefix), realHost, theRest;
+
+  splitUrl(url, realHost, theRest);
+  // The same server as both primary and spare
+  localUrl.append(realHost).append(hostsSeparator).append(realHost).append(theRest);
+
+  sql::Properties p{{"user", user}, {"password", passwd}, {"useTls", useTls ? "true" : "false"}, {"warmStandby", "true"}};
+
+  std::unique_ptr<sql::Connection> con1(driver->connect(localUrl, p));
+  std::unique_ptr<sql::Statement> stmt1(con1->createStatement());
+  con1->setAutoCommit(false);
+  con1->setTransactionIsolation(sql::TRANSACTION_READ_COMMITTED);
+  res.reset(stmt1->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(res->next());
+  int64_t connectionId= res->getLong(1);
+
+  // Giving time to open the spare connection
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  stmt->execute("KILL " + std::to_string(connectionId));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT(!con1->isValid(1));
+
+  con1->reconnect();
+  stmt1.reset(con1->createStatement());
+  res.reset(stmt1->executeQuery("SELECT CONNECTION_ID(), @@autocommit, @@tx_isolation"));
+  ASSERT(res->next());
+  ASSERT(connectionId != res->getLong(1));
+  ASSERT_EQUALS(0, res->getInt(2));
+  ASSERT_EQUALS("READ-COMMITTED", res->getString(3));
+  con1->commit();
+}
+
+
+void connection::trafficCounters()
+{
+  const std::size_t payload= 100000;
+  sql::SQLString longLiteral(std::string(payload, 'a'));
+
+  auto counter= [](sql::Connection* connection, const char* name) {
+    return std::stoll(connection->getClientOption(name).c_str());
+  };
+
+  ASSERT_EQUALS("", con->getClientOption("compressionAlgorithm"));
+  stmt.reset(con->createStatement());
+
+  int64_t received= counter(con.get(), "bytesReceived");
+  int64_t sent= counter(con.get(), "bytesSent");
+  res.reset(stmt->executeQuery("SELECT REPEAT('a', " + std::to_string(payload) + ")"));
+  ASSERT(res->next());
+  ASSERT(counter(con.get(), "bytesReceived") - received >= static_cast<int64_t>(payload));
+
+  res.reset(stmt->executeQuery("SELECT LENGTH('" + longLiteral + "')"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(static_cast<int64_t>(payload), res->getInt64(1));
+  ASSERT(counter(con.get(), "bytesSent") - sent >= static_cast<int64_t>(payload));
+
+  // Compressed traffic of the same highly compressible data is much smaller
+  sql::Properties p{{"user", user}, {"password", passwd}, {"useTls", useTls ? "true" : "false"}, {"compressionAlgorithm", "zlib"}};
+  Connection compressed(driver->connect(url, p));
+  ASSERT_EQUALS("zlib", compressed->getClientOption("compressionAlgorithm"));
+  Statement st(compressed->createStatement());
+  received= counter(compressed.get(), "bytesReceived");
+  res.reset(st->executeQuery("SELECT REPEAT('a', " + std::to_string(payload) + ")"));
+  ASSERT(res->next());
+  ASSERT(counter(compressed.get(), "bytesReceived") - received < static_cast<int64_t>(payload));
+}
+
+
 void connection::setUp()
 {
   super::setUp();
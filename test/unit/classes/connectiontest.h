@@ -96,6 +96,15 @@ public:
     TEST_CASE(concpp4_sequentialfailover);
     TEST_CASE(concpp105_conn_concurrency);
     TEST_CASE(concpp112_connection_attributes);
+    TEST_CASE(pipelineAuth);
+    TEST_CASE(sessionStateTracking);
+    TEST_CASE(staticGlobal);
+    TEST_CASE(parallelConnect);
+    TEST_CASE(loadBalance);
+    TEST_CASE(replication);
+    TEST_CASE(hostMonitor);
+    TEST_CASE(warmStandby);
+    TEST_CASE(trafficCounters);
   }
 
   /**
@@ -297,6 +306,27 @@ public:
   /* Setting of connection attributes for perfschema */
   void concpp112_connection_attributes();
 
+  /* Connection initialization queries sent in pipeline or as multi-statement */
+  void pipelineAuth();
+
+  /* Session state changes made with SQL statements are seen by the connection */
+  void sessionStateTracking();
+
+  /* Connections to the same server using cached global variables values */
+  void staticGlobal();
+
+  /* Connection attempts to multiple hosts started in parallel, and unavailable host skipped */
+  void parallelConnect();
+
+  /* LOADBALANCE mode, and skipping of hosts not in allowed Galera state */
+  void loadBalance();
+  void replication();
+  void hostMonitor();
+  void warmStandby();
+
+  /* Traffic counters and compression algorithm returned by getClientOption */
+  void trafficCounters();
+
   void setUp();
 };
 
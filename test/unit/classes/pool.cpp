@@ -33,6 +33,8 @@
 #include <array>
 #include <random>
 #include <thread>
+#include <mutex>
+#include <vector>
 #include <chrono>
 
 #include "Warning.hpp"
@@ -387,5 +389,433 @@ void pool::pool_pscache()
   // We can't really say the current number of PS
   //ASSERT_EQUALS(psCount, getPsCount(con));
 }
+
+/* Connections returned by a thread should be handed back to it most-recently-returned first, i.e. the
+ * warmest one is reused
+ */
+void pool::pool_lifo()
+{
+  sql::Properties p{{"user", user},
+                    {"password", passwd},
+                    {"useTls", useTls ? "true" : "false"},
+                    {"pool", "true"},
+                    {"minPoolSize", "2"},
+                    {"maxPoolSize", "2"},
+                   };
+  Connection c1(driver->connect(url, p)), c2(driver->connect(url, p));
+  int32_t id1, id2;
+
+  ASSERT(c1.get() && c2.get());
+  stmt.reset(c1->createStatement());
+  res.reset(stmt->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(res->next());
+  id1= res->getInt(1);
+  stmt.reset(c2->createStatement());
+  res.reset(stmt->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(res->next());
+  id2= res->getInt(1);
+  ASSERT(id1 != id2);
+  res.reset();
+  stmt.reset();
+
+  c1->close();
+  c2->close();
+
+  con.reset(driver->connect(url, p));
+  stmt.reset(con->createStatement());
+  res.reset(stmt->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(id2, res->getInt(1));
+
+  c1.reset(driver->connect(url, p));
+  stmt.reset(c1->createStatement());
+  res.reset(stmt->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(id1, res->getInt(1));
+  res.reset();
+  stmt.reset();
+  c1.reset();
+  con.reset();
+}
+
+/* With poolThreadAffinity the thread gets back the connection it has returned first, since the others have not fit
+ * into its slot. Other thread can still take all connections
+ */
+void pool::pool_affinity()
+{
+  constexpr std::size_t poolSize= 3;
+  sql::Properties p{{"user", user},
+                    {"password", passwd},
+                    {"useTls", useTls ? "true" : "false"},
+                    {"pool", "true"},
+                    {"minPoolSize", std::to_string(poolSize)},
+                    {"maxPoolSize", std::to_string(poolSize)},
+                    {"poolThreadAffinity", "true"},
+                   };
+  std::array<Connection, poolSize> c;
+  std::array<int32_t, poolSize> connId;
+
+  for (std::size_t i= 0; i < poolSize; ++i) {
+    c[i].reset(driver->connect(url, p));
+    ASSERT(c[i].get());
+    stmt.reset(c[i]->createStatement());
+    res.reset(stmt->executeQuery("SELECT CONNECTION_ID()"));
+    ASSERT(res->next());
+    connId[i]= res->getInt(1);
+  }
+  res.reset();
+  stmt.reset();
+
+  for (auto& conn : c) {
+    conn->close();
+  }
+  con.reset(driver->connect(url, p));
+  stmt.reset(con->createStatement());
+  res.reset(stmt->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(connId[0], res->getInt(1));
+  res.reset();
+  stmt.reset();
+  con->close();
+
+  // Other thread has to steal the connection parked for this one, to get all of them
+  bool allTaken= false;
+  std::thread other([&]() {
+    try {
+      std::array<Connection, poolSize> otherConn;
+      for (auto& conn : otherConn) {
+        conn.reset(driver->connect(url, p));
+      }
+      allTaken= true;
+    }
+    catch (sql::SQLException&) {
+    }
+  });
+  other.join();
+  ASSERT(allTaken);
+
+  con.reset();
+  for (auto& conn : c) {
+    conn.reset();
+  }
+}
+
+/* Pool statistics reflect connection checkouts and returns */
+void pool::pool_statistics()
+{
+  sql::SQLString localUrl(url);
+
+  if (localUrl.find_first_of('?') == sql::SQLString::npos) {
+    localUrl.append('?');
+  }
+  localUrl.append("minPoolSize=1&maxPoolSize=2&useTls=").append(useTls ? "true" : "false");
+
+  sql::mariadb::MariaDbDataSource ds(localUrl);
+  sql::mariadb::PoolStatistics stats;
+
+  ASSERT(!ds.getPoolStatistics(stats));
+  for (int32_t i= 0; i < 2; ++i) {
+    con.reset(ds.getConnection(user, passwd));
+    stmt.reset(con->createStatement());
+    res.reset(stmt->executeQuery("SELECT 1"));
+    res.reset();
+    stmt.reset();
+    con->close();
+  }
+  ASSERT(ds.getPoolStatistics(stats));
+  ASSERT(stats.totalConnections > 0);
+  ASSERT_EQUALS(stats.totalConnections, stats.idleConnections);
+  ASSERT_EQUALS(int64_t(0), stats.activeConnections);
+  ASSERT(stats.connectionsCreated >= stats.totalConnections);
+  ASSERT_EQUALS(int64_t(2), stats.acquireTime.count);
+  ASSERT_EQUALS(int64_t(2), stats.holdTime.count);
+  ASSERT_EQUALS(int64_t(2), stats.resetTime.count);
+  ASSERT_EQUALS(stats.validations, stats.validationTime.count);
+  ASSERT(stats.connectTime.count >= 1);
+  ASSERT(stats.acquireTime.percentile(0.5) <= stats.acquireTime.percentile(1.0));
+
+  con.reset();
+  ds.close();
+}
+
+/* minPoolSize connections are there once the first connection is returned, and have warm-up statements cached */
+void pool::pool_prefill()
+{
+  constexpr int32_t poolSize= 4;
+  sql::Properties p{{"user", user},
+                    {"password", passwd},
+                    {"useTls", useTls ? "true" : "false"},
+                    {"pool", "true"},
+                    {"minPoolSize", std::to_string(poolSize)},
+                    {"maxPoolSize", std::to_string(poolSize)},
+                    {"useServerPrepStmts", "true"},
+                    {"cachePrepStmts", "true"},
+                    {"poolWarmupStatements", "SELECT 1 WHERE 1=?; SELECT CONNECTION_ID()"},
+                   };
+  std::array<Connection, poolSize> c;
+
+  for (auto& conn : c) {
+    conn.reset(driver->connect(url, p));
+    ASSERT(conn.get());
+  }
+  // Each connection has prepared both warm-up statements, and preparing one of them again is served by the cache
+  for (auto& conn : c) {
+    stmt.reset(conn->createStatement());
+    res.reset(stmt->executeQuery("SHOW SESSION STATUS LIKE 'Com_stmt_prepare'"));
+    ASSERT(res->next());
+    int32_t prepared= res->getInt(2);
+    ASSERT_EQUALS(2, prepared);
+    pstmt.reset(conn->prepareStatement("SELECT 1 WHERE 1=?"));
+    res.reset(stmt->executeQuery("SHOW SESSION STATUS LIKE 'Com_stmt_prepare'"));
+    ASSERT(res->next());
+    ASSERT_EQUALS(prepared, res->getInt(2));
+  }
+  pstmt.reset();
+  res.reset();
+  stmt.reset();
+  for (auto& conn : c) {
+    conn.reset();
+  }
+}
+
+/* Connection returned to the pool is reset only if its session state has been changed, and prepared statements
+ * are prepared again after the reset
+ */
+void pool::pool_reset()
+{
+  sql::Properties p{{"user", user},
+                    {"password", passwd},
+                    {"useTls", useTls ? "true" : "false"},
+                    {"pool", "true"},
+                    {"minPoolSize", "1"},
+                    {"maxPoolSize", "1"},
+                    {"useServerPrepStmts", "true"},
+                    {"cachePrepStmts", "true"},
+                    {"skipUnchangedReset", "true"},
+                   };
+  auto comStmtPrepare= [this]() {
+    res.reset(stmt->executeQuery("SHOW SESSION STATUS LIKE 'Com_stmt_prepare'"));
+    ASSERT(res->next());
+    return res->getInt(2);
+  };
+  auto connectionId= [this]() {
+    res.reset(stmt->executeQuery("SELECT CONNECTION_ID()"));
+    ASSERT(res->next());
+    return res->getInt64(1);
+  };
+
+  con.reset(driver->connect(url, p));
+  pstmt.reset(con->prepareStatement("SELECT 1 WHERE 1=?"));
+  pstmt.reset(con->prepareStatement("SELECT 2 WHERE 2=?"));
+  pstmt.reset();
+  stmt.reset(con->createStatement());
+  stmt->execute("SET @pool_reset=1");
+  con->setAutoCommit(false);
+  stmt.reset();
+  con->close();
+
+  con.reset(driver->connect(url, p));
+  ASSERT(con->getAutoCommit());
+  stmt.reset(con->createStatement());
+  res.reset(stmt->executeQuery("SELECT @pool_reset IS NULL"));
+  ASSERT(res->next());
+  ASSERT(res->getBoolean(1));
+  // The first prepare after reset prepares again the other statement, that was in the cache
+  int32_t prepared= comStmtPrepare();
+  pstmt.reset(con->prepareStatement("SELECT 1 WHERE 1=?"));
+  ASSERT_EQUALS(prepared + 2, comStmtPrepare());
+  pstmt.reset(con->prepareStatement("SELECT 2 WHERE 2=?"));
+  ASSERT_EQUALS(prepared + 2, comStmtPrepare());
+  pstmt.reset();
+
+  // Only autocommit is changed via API - it is restored without the reset, that would close prepared statements
+  int64_t id= connectionId();
+  con->setAutoCommit(false);
+  stmt.reset();
+  res.reset();
+  con->close();
+
+  con.reset(driver->connect(url, p));
+  ASSERT(con->getAutoCommit());
+  stmt.reset(con->createStatement());
+  ASSERT_EQUALS(id, connectionId());
+  prepared= comStmtPrepare();
+  pstmt.reset(con->prepareStatement("SELECT 1 WHERE 1=?"));
+  pstmt.reset(con->prepareStatement("SELECT 2 WHERE 2=?"));
+  ASSERT_EQUALS(prepared, comStmtPrepare());
+  pstmt.reset();
+
+  // autocommit changed along with user variable in SQL - state change tracker does not tell what was changed
+  stmt->execute("SET @pool_reset=1, autocommit=0");
+  stmt.reset();
+  res.reset();
+  con->close();
+
+  con.reset(driver->connect(url, p));
+  ASSERT(con->getAutoCommit());
+  stmt.reset(con->createStatement());
+  res.reset(stmt->executeQuery("SELECT @pool_reset IS NULL"));
+  ASSERT(res->next());
+  ASSERT(res->getBoolean(1));
+  prepared= comStmtPrepare();
+  pstmt.reset(con->prepareStatement("SELECT 1 WHERE 1=?"));
+  ASSERT(comStmtPrepare() > prepared);
+  pstmt.reset();
+  stmt.reset();
+  res.reset();
+  con.reset();
+}
+
+/* Idle connection killed at the server is detected locally, and is not given out */
+void pool::pool_validation()
+{
+  sql::SQLString localUrl(url);
+
+  if (localUrl.find_first_of('?') == sql::SQLString::npos) {
+    localUrl.append('?');
+  }
+  localUrl.append("minPoolSize=1&maxPoolSize=1&poolValidMinDelay=0&useTls=").append(useTls ? "true" : "false");
+
+  sql::mariadb::MariaDbDataSource ds(localUrl);
+  sql::mariadb::PoolStatistics stats;
+
+  con.reset(ds.getConnection(user, passwd));
+  stmt.reset(con->createStatement());
+  res.reset(stmt->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(res->next());
+  int64_t connectionId= res->getInt64(1);
+  res.reset();
+  stmt.reset();
+  con->close();
+
+  Connection killer(driver->connect(url, user, passwd));
+  stmt.reset(killer->createStatement());
+  stmt->execute("KILL " + std::to_string(connectionId));
+  stmt.reset();
+  killer.reset();
+  // Giving the server time to close the socket
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+  con.reset(ds.getConnection(user, passwd));
+  stmt.reset(con->createStatement());
+  res.reset(stmt->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(res->next());
+  ASSERT(connectionId != res->getInt64(1));
+  res.reset();
+  stmt.reset();
+  con->close();
+
+  ASSERT(ds.getPoolStatistics(stats));
+  ASSERT(stats.socketChecksFailed >= 1);
+  ASSERT(stats.socketChecks >= stats.socketChecksFailed);
+
+  con.reset();
+  ds.close();
+}
+
+/* With adaptive sizing the pool keeps connections for the peak demand of the window, even though it's above
+ * minPoolSize and connections are idle
+ */
+void pool::pool_adaptive()
+{
+  constexpr int32_t demand= 4;
+  sql::SQLString localUrl(url);
+
+  if (localUrl.find_first_of('?') == sql::SQLString::npos) {
+    localUrl.append('?');
+  }
+  localUrl.append("minPoolSize=1&maxPoolSize=8&poolAdaptiveSizing=true&poolSizingWindow=30&poolMaxConnectRate=50&useTls=")
+    .append(useTls ? "true" : "false");
+
+  sql::mariadb::MariaDbDataSource ds(localUrl);
+  sql::mariadb::PoolStatistics stats;
+  std::array<Connection, demand> c;
+
+  for (auto& conn : c) {
+    conn.reset(ds.getConnection(user, passwd));
+    ASSERT(conn.get());
+  }
+  // Demand is sampled once per second
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  for (auto& conn : c) {
+    conn->close();
+  }
+  std::this_thread::sleep_for(std::chrono::seconds(3));
+
+  ASSERT(ds.getPoolStatistics(stats));
+  ASSERT(stats.targetConnections >= demand);
+  ASSERT(stats.totalConnections >= demand);
+  ASSERT_EQUALS(int64_t(0), stats.activeConnections);
+
+  for (auto& conn : c) {
+    conn.reset();
+  }
+  ds.close();
+}
+
+/* Returned connection goes to the high priority waiter first, even though low priority one waits longer. With
+ * poolFailFast request fails right away, if connections are held longer than connectTimeout
+ */
+void pool::pool_waiters()
+{
+  sql::SQLString localUrl(url);
+
+  if (localUrl.find_first_of('?') == sql::SQLString::npos) {
+    localUrl.append('?');
+  }
+  localUrl.append("minPoolSize=1&maxPoolSize=1&connectTimeout=1000&poolFailFast=true&useTls=")
+    .append(useTls ? "true" : "false");
+
+  sql::mariadb::MariaDbDataSource ds(localUrl);
+  sql::mariadb::PoolStatistics stats;
+  std::mutex orderLock;
+  std::vector<sql::mariadb::PoolPriority> order;
+
+  auto waiter= [&](sql::mariadb::PoolPriority priority) {
+    try {
+      Connection conn(ds.getConnection(user, passwd, priority));
+      {
+        std::lock_guard<std::mutex> lock(orderLock);
+        order.push_back(priority);
+      }
+      conn->close();
+    }
+    catch (sql::SQLException&) {
+    }
+  };
+
+  con.reset(ds.getConnection(user, passwd));
+  std::thread low(waiter, sql::mariadb::PoolPriority::LOW);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  std::thread high(waiter, sql::mariadb::PoolPriority::HIGH);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  con->close();
+  low.join();
+  high.join();
+
+  ASSERT_EQUALS(static_cast<std::size_t>(2), order.size());
+  ASSERT(order[0] == sql::mariadb::PoolPriority::HIGH);
+  ASSERT(order[1] == sql::mariadb::PoolPriority::LOW);
+
+  // Holding the only connection much longer than connectTimeout makes the average hold time exceed it
+  con.reset(ds.getConnection(user, passwd));
+  std::this_thread::sleep_for(std::chrono::milliseconds(5000));
+  con->close();
+  con.reset(ds.getConnection(user, passwd));
+
+  auto start= std::chrono::steady_clock::now();
+  try {
+    Connection conn(ds.getConnection(user, passwd));
+    FAIL("Connection request should have failed");
+  }
+  catch (sql::SQLException&) {
+  }
+  ASSERT(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500));
+  ASSERT(ds.getPoolStatistics(stats));
+  ASSERT_EQUALS(int64_t(1), stats.acquiresRejected);
+
+  con.reset();
+  ds.close();
+}
 } /* namespace connection */
 } /* namespace testsuite */
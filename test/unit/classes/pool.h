@@ -50,6 +50,14 @@ public:
     TEST_CASE(pool_datasource);
     TEST_CASE(pool_idle);
     TEST_CASE(pool_pscache);
+    TEST_CASE(pool_lifo);
+    TEST_CASE(pool_affinity);
+    TEST_CASE(pool_statistics);
+    TEST_CASE(pool_prefill);
+    TEST_CASE(pool_reset);
+    TEST_CASE(pool_validation);
+    TEST_CASE(pool_adaptive);
+    TEST_CASE(pool_waiters);
   }
 
   /* Simple test of the connection pool */
@@ -60,6 +68,22 @@ public:
   void pool_idle();
   /* Test of pool with ps cache enabled */
   void pool_pscache();
+  /* Idle connections are reused most-recently-returned first */
+  void pool_lifo();
+  /* Test of poolThreadAffinity option */
+  void pool_affinity();
+  /* Test of pool statistics */
+  void pool_statistics();
+  /* Test of parallel pool pre-fill and warm-up statements */
+  void pool_prefill();
+  /* Test of skipping the reset of unchanged connection */
+  void pool_reset();
+  /* Test of local validation of idle connection, killed at the server */
+  void pool_validation();
+  /* Test of poolAdaptiveSizing option */
+  void pool_adaptive();
+  /* Test of waiters priority and poolFailFast option */
+  void pool_waiters();
 };
 
 
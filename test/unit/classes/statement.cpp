@@ -37,6 +37,10 @@
 #include "statementtest.h"
 #include <stdlib.h>
 #include <time.h>
+#include <thread>
+#include <set>
+#include <algorithm>
+#include <iterator>
 
 namespace testsuite
 {
@@ -803,5 +807,90 @@ void statement::multirs_caching()
   ASSERT(stmt1->getUpdateCount() == -1);
 }
 
+
+void statement::batchTimeout()
+{
+  stmt->setQueryTimeout(1);
+
+  for (int32_t i= 0; i < 5; ++i) {
+    stmt->addBatch("DO SLEEP(1)");
+  }
+  time_t t1= time(nullptr);
+  try
+  {
+    stmt->executeBatch();
+    FAIL("Batch timeout has not been triggered");
+  }
+  catch (sql::SQLException &e)
+  {
+    ASSERT_EQUALS("70100", e.getSQLState());
+  }
+  time_t t2= time(nullptr);
+  ASSERT((t2 - t1) < 5);
+
+  // Connection has to be usable after that, and the timer must not fire for the next statement
+  stmt->clearBatch();
+  stmt->setQueryTimeout(0);
+  res.reset(stmt->executeQuery("SELECT 1"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(1, res->getInt(1));
+}
+
+
+void statement::cancelQuery()
+{
+  // Option value no other test uses, so the control connection is not shared with other tests' connections
+  sql::ConnectOptionsMap connection_properties{{"maxQuerySizeToLog", "1027"}};
+  Connection con1(getConnection(&connection_properties));
+  Statement st1(con1->createStatement());
+  Statement st2(con->createStatement());
+  auto sessions= [&st2]() {
+    std::set<int64_t> ids;
+    ResultSet rs(st2->executeQuery("SELECT ID FROM information_schema.PROCESSLIST WHERE USER=SUBSTRING_INDEX(USER(),'@',1)"));
+    while (rs->next()) {
+      ids.insert(rs->getInt64(1));
+    }
+    return ids;
+  };
+  const std::set<int64_t> before(sessions());
+  std::set<int64_t> control;
+
+  for (int32_t i= 0; i < 3; ++i) {
+    std::thread canceller([&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+      st1->cancel();
+    });
+    time_t t1= time(nullptr);
+    try
+    {
+      st1->execute("SELECT SLEEP(5)");
+    }
+    catch (sql::SQLException &)
+    {
+    }
+    canceller.join();
+    ASSERT((time(nullptr) - t1) < 5);
+
+    // Sessions of this user, that have appeared since the test start. The control connection is one of them
+    std::set<int64_t> added;
+    for (int64_t id : sessions()) {
+      if (before.find(id) == before.end()) {
+        added.insert(id);
+      }
+    }
+    // First cancel creates the control connection, the rest have to reuse it, i.e. its thread id stays the same
+    if (i == 0) {
+      control= added;
+    }
+    else {
+      std::set<int64_t> stillThere;
+      std::set_intersection(control.begin(), control.end(), added.begin(), added.end(),
+        std::inserter(stillThere, stillThere.begin()));
+      control= stillThere;
+    }
+    ASSERT(!control.empty());
+  }
+}
+
 } /* namespace statement */
 } /* namespace testsuite */
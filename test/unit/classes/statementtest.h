@@ -70,6 +70,8 @@ public:
     TEST_CASE(concpp99_batchRewrite);
     TEST_CASE(otherstmts_result);
     TEST_CASE(multirs_caching);
+    TEST_CASE(batchTimeout);
+    TEST_CASE(cancelQuery);
   }
 
   /**
@@ -127,6 +129,12 @@ public:
 
   void otherstmts_result();
   void multirs_caching();
+
+  /* Query timeout of the batch is handled by the client side timer */
+  void batchTimeout();
+
+  /* Cancellation of the running query. Repeated cancels must not open new connections */
+  void cancelQuery();
 };
 
 REGISTER_FIXTURE(statement);